@@ -32,6 +32,7 @@
 #include "crawler.h"
 #include "hoverbike.h"
 //###
+#include "../elib/qstring.h"
 
 //#define DEBUG_PRINT
 
@@ -50,6 +51,196 @@ static const Vector movetweak{0, 0, 2};
 
 #define TURN_SPEED 30
 
+/*
+==============
+=
+= Action names
+=
+= Everything an actor can respond to is given a number the first time it's
+= seen, so actors keep their responses in a table indexed by action number.
+= The storage here is all zero initialized so that actions can be registered
+= from static initializers in any file.
+=
+==============
+*/
+
+#define ACTION_HASHSIZE 256
+
+typedef struct actionname_s
+{
+   const char           *name;     // interned
+   int                   num;
+   struct actionname_s  *next;
+} actionname_t;
+
+static actionname_t  *actionHash[ACTION_HASHSIZE];
+static const char   **actionNames    = nullptr;
+static int            numActions     = 0;
+static int            maxActions     = 0;
+
+int G_ActionNum(const char *name)
+{
+   actionname_t *a;
+   const char  **names;
+   unsigned      hash;
+
+   hash = qstring::HashCodeCaseStatic(name) % ACTION_HASHSIZE;
+   for(a = actionHash[hash]; a; a = a->next)
+   {
+      if(!strcmp(a->name, name))
+      {
+         return a->num;
+      }
+   }
+
+   // 0 is reserved for no action
+   if(numActions + 1 >= maxActions)
+   {
+      maxActions = maxActions ? maxActions * 2 : 64;
+      names = (const char **)malloc(maxActions * sizeof(const char *));
+      if(actionNames)
+      {
+         memcpy(names, actionNames, (numActions + 1) * sizeof(const char *));
+         free(actionNames);
+      }
+      else
+      {
+         names[0] = "";
+      }
+      actionNames = names;
+   }
+
+   a = (actionname_t *)malloc(sizeof(actionname_t));
+   a->name = G_InternScriptString(name);
+   a->num  = ++numActions;
+   a->next = actionHash[hash];
+   actionHash[hash] = a;
+   actionNames[a->num] = a->name;
+
+   return a->num;
+}
+
+const char *G_ActionName(int action)
+{
+   if((action < 1) || (action > numActions))
+   {
+      return "";
+   }
+
+   return actionNames[action];
+}
+
+int G_NumActions(void)
+{
+   return numActions;
+}
+
+// actions that are triggered from code every time an actor's situation changes
+static int actionSightEnemy   = G_ActionNum("sightenemy");
+static int actionEnemyDead    = G_ActionNum("enemydead");
+static int actionRangeMelee   = G_ActionNum("range_melee");
+static int actionRangeNear    = G_ActionNum("range_near");
+static int actionRangeMid     = G_ActionNum("range_mid");
+static int actionRangeFar     = G_ActionNum("range_far");
+static int actionHealthOk     = G_ActionNum("health_ok");
+static int actionHealthMed    = G_ActionNum("health_med");
+static int actionHealthLow    = G_ActionNum("health_low");
+static int actionHealthDanger = G_ActionNum("health_danger");
+static int actionPain         = G_ActionNum("pain");
+
+/*
+==============
+=
+= ActorState pool
+=
+= Actors push a state every time they respond to an action, so the states
+= are kept around once they're popped instead of being constructed again.
+= States are handed back with nothing left in them to free.  The copies of
+= the action/response list that go with them are pooled the same way.
+=
+==============
+*/
+
+#define MAX_FREE_ACTORSTATES 64
+#define MAX_FREE_STATEINFOS  1024
+
+static Container<StateInfo *> freeStateInfos;
+
+static StateInfo *AllocStateInfo(void)
+{
+   StateInfo *info;
+   int        n;
+
+   n = freeStateInfos.NumObjects();
+   if(n)
+   {
+      info = freeStateInfos.ObjectAt(n);
+      freeStateInfos.RemoveObjectAt(n);
+      return info;
+   }
+
+   return new StateInfo();
+}
+
+static void FreeStateInfo(StateInfo *info)
+{
+   if(freeStateInfos.NumObjects() >= MAX_FREE_STATEINFOS)
+   {
+      delete info;
+      return;
+   }
+
+   freeStateInfos.AddObject(info);
+}
+
+static void FreeStateInfoList(Container<StateInfo *> &list)
+{
+   int n;
+   int i;
+
+   n = list.NumObjects();
+   for(i = n; i >= 1; i--)
+   {
+      FreeStateInfo(list.ObjectAt(i));
+   }
+   list.ClearObjectList();
+}
+
+static Container<ActorState *> freeActorStates;
+
+static ActorState *AllocActorState(void)
+{
+   ActorState *state;
+   int         n;
+
+   n = freeActorStates.NumObjects();
+   if(n)
+   {
+      state = freeActorStates.ObjectAt(n);
+      freeActorStates.RemoveObjectAt(n);
+      return state;
+   }
+
+   return new ActorState();
+}
+
+static void FreeActorState(ActorState *state)
+{
+   assert(!state->actionList.NumObjects());
+
+   if(freeActorStates.NumObjects() >= MAX_FREE_ACTORSTATES)
+   {
+      delete state;
+      return;
+   }
+
+   state->animDoneEvent = nullptr;
+   state->behavior      = nullptr;
+   state->path          = nullptr;
+   state->thread        = -1;
+   freeActorStates.AddObject(state);
+}
+
 CLASS_DECLARATION( Sentient, Actor, "monster_generic" );
 
 Event EV_Actor_CrouchSize( "crouchsize" );
@@ -431,9 +622,6 @@ Actor::Actor()
 
 Actor::~Actor()
 {
-   int n;
-   int i;
-
    if(newanimevent) //### SINEX_TODO: this should be applied to the normal gamecode also (plugs memory leak)
    {
       delete newanimevent;
@@ -446,13 +634,11 @@ Actor::~Actor()
       actorthread = NULL;
    }
 
-   // delete the old action/response list
-   n = actionList.NumObjects();
-   for(i = n; i >= 1; i--)
-   {
-      delete actionList.ObjectAt(i);
-   }
-   actionList.ClearObjectList();
+   // free the old action/response list
+   FreeStateInfoList(actionList);
+   delete[] actionTable;
+   actionTable = nullptr;
+   actionTableSize = 0;
    if(behavior)
    {
       delete behavior;
@@ -498,6 +684,7 @@ void Actor::Start(Event *ev)
    droptofloor(16);
 
    flags |= FL_PRETHINK;
+   Wake();
 
    // see if we have any melee attacks
    if(HasAnim("melee"))
@@ -615,6 +802,71 @@ qboolean Actor::CanSee(Entity *ent)
    return CanSeeFrom(worldorigin, ent);
 }
 
+#define MAX_SIGHT_BATCH 8
+
+//
+// Same checks as CanSeeFrom, done for several positions at once.  Returns
+// the number of positions that ent can be seen from.
+//
+int Actor::CanSeeFromCount(const Vector *positions, int num, Entity *ent)
+{
+   tracerequest_t requests[MAX_SIGHT_BATCH];
+   trace_t        results[MAX_SIGHT_BATCH];
+   int            remaining[MAX_SIGHT_BATCH];
+   Vector         p;
+   int            count;
+   int            n;
+   int            i;
+
+   assert(num <= MAX_SIGHT_BATCH);
+
+   p = ent->centroid;
+
+   // Check if he's visible
+   for(i = 0; i < num; i++)
+   {
+      G_SetTraceRequest(&requests[i], positions[i] + eyeposition, vec_zero, vec_zero, p, this, MASK_OPAQUE, "Actor::CanSeeFrom 1");
+   }
+   G_TraceBatch(requests, results, num);
+
+   count = 0;
+   n = 0;
+   for(i = 0; i < num; i++)
+   {
+      if(results[i].fraction == 1.0 || results[i].ent == ent->edict)
+      {
+         count++;
+      }
+      else
+      {
+         remaining[n++] = i;
+      }
+   }
+
+   if(!n)
+   {
+      return count;
+   }
+
+   // Check if his head is visible from the rest
+   p.z = ent->absmax.z;
+   for(i = 0; i < n; i++)
+   {
+      G_SetTraceRequest(&requests[i], positions[remaining[i]] + eyeposition, vec_zero, vec_zero, p, this, MASK_OPAQUE, "Actor::CanSeeFrom 2");
+   }
+   G_TraceBatch(requests, results, n);
+
+   for(i = 0; i < n; i++)
+   {
+      if(results[i].fraction == 1.0 || results[i].ent == ent->edict)
+      {
+         count++;
+      }
+   }
+
+   return count;
+}
+
 int Actor::EnemyCanSeeMeFrom(Vector pos)
 {
    Entity	*ent;
@@ -624,6 +876,7 @@ int Actor::EnemyCanSeeMeFrom(Vector pos)
    Vector	d;
    Vector	p1;
    Vector	p2;
+   Vector	points[4];
    int		c;
 
    rad = max(size.x, size.y) * 1.44 * 0.5;
@@ -654,24 +907,14 @@ int Actor::EnemyCanSeeMeFrom(Vector pos)
          p1.z = mins.z;
          p2.z = maxs.z;
 
-         if(CanSeeFrom(pos + p1, ent))
-         {
-            c++;
-         }
-         if(CanSeeFrom(pos + p2, ent))
-         {
-            c++;
-         }
+         points[0] = pos + p1;
+         points[1] = pos + p2;
          p1.z = -p1.z;
          p2.z = -p2.z;
-         if(CanSeeFrom(pos - p1, ent))
-         {
-            c++;
-         }
-         if(CanSeeFrom(pos - p2, ent))
-         {
-            c++;
-         }
+         points[2] = pos - p1;
+         points[3] = pos - p2;
+
+         c += CanSeeFromCount(points, 4, ent);
       }
    }
 
@@ -1141,7 +1384,7 @@ qboolean Actor::HasEnemies(void)
 
 qboolean Actor::IsEnemy(Entity *ent)
 {
-   return enemyList.ObjectInList(EntityPtr(ent)) && seenEnemy;
+   return enemyList.ObjectInList(EntityHandle(ent)) && seenEnemy;
 }
 
 void Actor::MakeEnemy(Entity *ent, qboolean force)
@@ -1153,15 +1396,15 @@ void Actor::MakeEnemy(Entity *ent, qboolean force)
       !(ent->flags & FL_NOTARGET) &&
       (ent->takedamage != DAMAGE_NO))
    {
-      if(!enemyList.ObjectInList(EntityPtr(ent)))
+      if(!enemyList.ObjectInList(EntityHandle(ent)))
       {
-         enemyList.AddObject(EntityPtr(ent));
+         enemyList.AddObject(EntityHandle(ent));
       }
 
       if(!currentEnemy && !seenEnemy)
       {
          currentEnemy = ent;
-         if(DoAction("sightenemy", force))
+         if(DoAction(actionSightEnemy, force))
          {
             seenEnemy = true;
             Chatter("snd_sightenemy", 5);
@@ -1294,10 +1537,10 @@ qboolean Actor::GetVisibleTargets(void)
       {
          if(WithinDistance(ent, vision_distance) && CanSeeFOV(ent))
          {
-            targetList.AddObject(EntityPtr(ent));
+            targetList.AddObject(EntityHandle(ent));
             if(WithinDistance(ent, 96))
             {
-               nearbyList.AddObject(EntityPtr(ent));
+               nearbyList.AddObject(EntityHandle(ent));
             }
             MakeEnemy(ent);
          }
@@ -1309,10 +1552,10 @@ qboolean Actor::GetVisibleTargets(void)
          {
             if(WithinDistance(ent, vision_distance) && CanSeeFOV(ent))
             {
-               targetList.AddObject(EntityPtr(ent));
+               targetList.AddObject(EntityHandle(ent));
                if(WithinDistance(ent, 96))
                {
-                  nearbyList.AddObject(EntityPtr(ent));
+                  nearbyList.AddObject(EntityHandle(ent));
                }
                MakeEnemy(act->currentEnemy);
                if(act->deadflag)
@@ -1365,7 +1608,7 @@ void Actor::TargetEnemies(Event *ev)
    {
       seenEnemy = false;
       currentEnemy = newtarget;
-      if(DoAction("sightenemy"))
+      if(DoAction(actionSightEnemy))
       {
          seenEnemy = true;
          Chatter("snd_sightenemy", 5);
@@ -1522,18 +1765,22 @@ void Actor::DisableState(str action)
 StateInfo *Actor::SetResponse(str action, str response, qboolean ignore)
 {
    StateInfo *ptr;
+   int num;
 
-   ptr = GetState(action);
+   num = G_ActionNum(action.c_str());
+   ptr = GetState(num);
    if(!ptr)
    {
-      ptr = new StateInfo();
+      ptr = AllocStateInfo();
 
       actionList.AddObject(ptr);
-      ptr->action = action;
+      ptr->action = num;
+      LinkAction(ptr);
    }
 
-   ptr->response = response;
+   ptr->response = G_InternScriptString(response.c_str());
    ptr->ignore   = ignore;
+   memset(&ptr->label, 0, sizeof(ptr->label));
 
    return ptr;
 }
@@ -1545,29 +1792,64 @@ const char *Actor::GetResponse(str action, qboolean force)
    ptr = GetState(action);
    if(ptr && (force || !ptr->ignore))
    {
-      return ptr->response.c_str();
+      return ptr->response;
    }
 
    return "";
 }
 
 StateInfo *Actor::GetState(str action)
+{
+   return GetState(G_ActionNum(action.c_str()));
+}
+
+StateInfo *Actor::GetState(int action)
+{
+   if(action < actionTableSize)
+   {
+      return actionTable[action];
+   }
+
+   return NULL;
+}
+
+void Actor::LinkAction(StateInfo *ptr)
+{
+   StateInfo **table;
+   int size;
+
+   if(ptr->action >= actionTableSize)
+   {
+      size = G_NumActions() + 16;
+      table = new StateInfo *[size];
+      memset(table, 0, size * sizeof(StateInfo *));
+      if(actionTable)
+      {
+         memcpy(table, actionTable, actionTableSize * sizeof(StateInfo *));
+         delete[] actionTable;
+      }
+      actionTable = table;
+      actionTableSize = size;
+   }
+
+   actionTable[ptr->action] = ptr;
+}
+
+void Actor::BuildActionTable(void)
 {
    int i;
    int n;
-   StateInfo *ptr;
+
+   if(actionTable)
+   {
+      memset(actionTable, 0, actionTableSize * sizeof(StateInfo *));
+   }
 
    n = actionList.NumObjects();
    for(i = 1; i <= n; i++)
    {
-      ptr = actionList.ObjectAt(i);
-      if(ptr->action == action)
-      {
-         return ptr;
-      }
+      LinkAction(actionList.ObjectAt(i));
    }
-
-   return NULL;
 }
 
 //***********************************************************************************************
@@ -1579,8 +1861,6 @@ StateInfo *Actor::GetState(str action)
 void Actor::ClearStateStack(void)
 {
    ActorState *state;
-   int n;
-   int i;
 
    while(!stateStack.Empty())
    {
@@ -1591,13 +1871,8 @@ void Actor::ClearStateStack(void)
          delete state->animDoneEvent;
       }
 
-      // delete the old action/response list
-      n = state->actionList.NumObjects();
-      for(i = n; i >= 1; i--)
-      {
-         delete state->actionList.ObjectAt(i);
-      }
-      state->actionList.ClearObjectList();
+      // free the old action/response list
+      FreeStateInfoList(state->actionList);
 
       if(state->behavior)
       {
@@ -1609,7 +1884,7 @@ void Actor::ClearStateStack(void)
          delete state->path;
       }
 
-      delete state;
+      FreeActorState(state);
    }
 
    numonstack = 0;
@@ -1685,13 +1960,8 @@ qboolean Actor::PopState(void)
          thread = NULL;
       }
 
-      // delete the old action/response list
-      n = actionList.NumObjects();
-      for(i = n; i >= 1; i--)
-      {
-         delete actionList.ObjectAt(i);
-      }
-      actionList.ClearObjectList();
+      // free the old action/response list
+      FreeStateInfoList(actionList);
 
       // Copy the new action/response list
       n = newstate->actionList.NumObjects();
@@ -1699,12 +1969,14 @@ qboolean Actor::PopState(void)
       {
          actionList.AddObject(newstate->actionList.ObjectAt(i));
       }
+      newstate->actionList.ClearObjectList();
+      BuildActionTable();
 
       assert(!behavior);
 
       SetBehavior(newstate->behavior, NULL, thread);
 
-      delete newstate;
+      FreeActorState(newstate);
    }
    else
    {
@@ -1725,7 +1997,7 @@ void Actor::PushState(const char *newstate, ScriptThread *newthread, ThreadMarke
    int i;
    int n;
 
-   oldstate = new ActorState();
+   oldstate = AllocActorState();
 
    // push the old state
 #ifdef DEBUG_PRINT
@@ -1764,10 +2036,11 @@ void Actor::PushState(const char *newstate, ScriptThread *newthread, ThreadMarke
       StateInfo *newobj;
 
       ptr = actionList.ObjectAt(i);
-      newobj = new StateInfo();
+      newobj = AllocStateInfo();
       newobj->action = ptr->action;
       newobj->response = ptr->response;
       newobj->ignore = ptr->ignore;
+      newobj->label = ptr->label;
       oldstate->actionList.AddObject(newobj);
    }
 
@@ -1956,12 +2229,12 @@ void Actor::SetStateEvent(Event *ev)
    }
 
    actorthread->Mark(&marker);
-   if(response != "" && actorthread->Goto(response.c_str()))
+   if(response != "" && actorthread->Goto(response.c_str(), ptr ? &ptr->label : nullptr))
    {
       PushState(name.c_str(), actorthread, &marker);
       SetAnim("idle");
       animname = "idle";
-      SetVariable("state", name.c_str());
+      SetVariable(stateVar, name.c_str());
       ProcessScript(actorthread);
    }
    else
@@ -2043,7 +2316,13 @@ void Actor::SetupThread(void)
 
 qboolean Actor::DoAction(str name, qboolean force)
 {
-   str response;
+   return DoAction(G_ActionNum(name.c_str()), force);
+}
+
+qboolean Actor::DoAction(int action, qboolean force)
+{
+   StateInfo *ptr;
+   const char *name;
    ThreadMarker marker;
 
    if(!actorthread)
@@ -2056,19 +2335,25 @@ qboolean Actor::DoAction(str name, qboolean force)
       return false;
    }
 
-   response = GetResponse(name, force);
+   ptr = GetState(action);
+   if(!ptr || (ptr->ignore && !force) || !ptr->response[0])
+   {
+      return false;
+   }
+
+   name = G_ActionName(action);
 
 #ifdef DEBUG_PRINT
-   gi.dprintf("Action: %s - %s\n", name.c_str(), response.c_str());
+   gi.dprintf("Action: %s - %s\n", name, ptr->response);
 #endif
 
    actorthread->Mark(&marker);
-   if(response != "" && actorthread->Goto(response.c_str()))
+   if(actorthread->Goto(ptr->response, &ptr->label))
    {
-      PushState(name.c_str(), actorthread, &marker);
+      PushState(name, actorthread, &marker);
       SetAnim("idle");
       animname = "idle";
-      SetVariable("state", name.c_str());
+      SetVariable(stateVar, name);
       ProcessScript(actorthread);
       return true;
    }
@@ -2192,6 +2477,31 @@ inline ScriptVariable *Actor::SetVariable(const char *name, Vector &vec)
    return NULL;
 }
 
+inline ScriptVariable *Actor::SetVariable(ScriptVariableSlot &slot, const char *text)
+{
+   ScriptVariable *var;
+
+   if(actorthread)
+   {
+      var = slot.Resolve(actorthread->Vars());
+      var->setStringValue(text);
+      return var;
+   }
+
+   return NULL;
+}
+
+inline ScriptVariable *Actor::SetVariable(ScriptVariableSlot &slot, Entity *ent)
+{
+   if(!ent)
+   {
+      // use the world
+      return SetVariable(slot, "*0");
+   }
+
+   return SetVariable(slot, va("*%d", ent->entnum));
+}
+
 //***********************************************************************************************
 //
 // Thread based script commands
@@ -2371,6 +2681,7 @@ void Actor::SetBehavior(Behavior *newbehavior, Event *startevent, ScriptThread *
       {
          // think while we have a behavior
          flags |= FL_PRETHINK;
+         Wake();
       }
 
 #ifdef DEBUG_PRINT
@@ -2903,7 +3214,7 @@ void Actor::IfNearEvent(Event *ev)
       ent = ev->GetEntity(1);
       if(WithinDistance(ent, distance))
       {
-         SetVariable("other", ent);
+         SetVariable(otherVar, ent);
          thread->ProcessCommandFromEvent(ev, 3);
       }
    }
@@ -2928,7 +3239,7 @@ void Actor::IfNearEvent(Event *ev)
 
       if(bestent)
       {
-         SetVariable("other", bestent);
+         SetVariable(otherVar, bestent);
          thread->ProcessCommandFromEvent(ev, 3);
       }
    }
@@ -2954,7 +3265,7 @@ void Actor::IfNearEvent(Event *ev)
 
       if(bestent)
       {
-         SetVariable("other", bestent);
+         SetVariable(otherVar, bestent);
          thread->ProcessCommandFromEvent(ev, 3);
       }
    }
@@ -3160,7 +3471,7 @@ void Actor::InvestigateWeaponSound(Event *ev)
    {
       other = ev->GetEntity(1);
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("weaponsound"))
       {
@@ -3178,7 +3489,7 @@ void Actor::InvestigateMovementSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("movementsound"))
          nextsoundtime = level.time + 2;
@@ -3194,7 +3505,7 @@ void Actor::InvestigatePainSound(Event *ev)
    {
       other = ev->GetEntity(1);
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("painsound"))
          nextsoundtime = level.time + 2;
@@ -3210,7 +3521,7 @@ void Actor::InvestigateDeathSound(Event *ev)
    {
       other = ev->GetEntity(1);
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("deathsound"))
          nextsoundtime = level.time + 2;
@@ -3226,7 +3537,7 @@ void Actor::InvestigateBreakingSound(Event *ev)
    {
       other = ev->GetEntity(1);
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("breakingsound"))
          nextsoundtime = level.time + 2;
@@ -3242,7 +3553,7 @@ void Actor::InvestigateDoorSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("doorsound"))
          nextsoundtime = level.time + 2;
@@ -3258,7 +3569,7 @@ void Actor::InvestigateMutantSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("mutantsound"))
          nextsoundtime = level.time + 2;
@@ -3274,7 +3585,7 @@ void Actor::InvestigateVoiceSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("voicesound"))
          nextsoundtime = level.time + 2;
@@ -3290,7 +3601,7 @@ void Actor::InvestigateMachineSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("machinesound"))
          nextsoundtime = level.time + 2;
@@ -3306,7 +3617,7 @@ void Actor::InvestigateRadioSound(Event *ev)
    if(other && !currentEnemy && !deadflag && (nextsoundtime < level.time) && Hates(other))
    {
       location = ev->GetVector(2);
-      SetVariable("other", other);
+      SetVariable(otherVar, other);
       SetVariable("location", location);
       if(DoAction("radiosound"))
          nextsoundtime = level.time + 2;
@@ -3351,24 +3662,24 @@ void Actor::Pain(Event *ev)
    oldhealth = (health + damage) / max_health;
    newhealth = health / max_health;
 
-   SetVariable("other", ev->GetEntity(2));
+   SetVariable(otherVar, ev->GetEntity(2));
 
    // If we pass more than one range,  
    if((oldhealth > 0.75) && (newhealth <= 0.75))
    {
-      DoAction("health_ok");
+      DoAction(actionHealthOk);
    }
    if((oldhealth > 0.5) && (newhealth <= 0.5))
    {
-      DoAction("health_med");
+      DoAction(actionHealthMed);
    }
    if((oldhealth > 0.25) && (newhealth <= 0.25))
    {
-      DoAction("health_low");
+      DoAction(actionHealthLow);
    }
    if((oldhealth > 0.1) && (newhealth <= 0.1))
    {
-      DoAction("health_danger");
+      DoAction(actionHealthDanger);
    }
 
    if(damage <= pain_threshold)
@@ -3403,7 +3714,7 @@ void Actor::Pain(Event *ev)
       }
 
       SetVariable("painanim", aname.c_str());
-      DoAction("pain");
+      DoAction(actionPain);
    }
 }
 
@@ -3542,7 +3853,7 @@ void Actor::Killed(Event *ev)
    // Double all the armor
    DoubleArmor();
 
-   SetVariable("other", ev->GetEntity(1));
+   SetVariable(otherVar, ev->GetEntity(1));
    if(!DoAction("killed") && actorthread)
    {
       actorthread->ProcessEvent(EV_ScriptThread_End);
@@ -4270,7 +4581,7 @@ stepmoveresult_t Actor::TryMove(void)
          door = (Door *)ent;
          if(!door->locked && !door->isOpen())
          {
-            SetVariable("other", ent);
+            SetVariable(otherVar, ent);
             SetVariable("dir", end - worldorigin);
             ForceAction("opendoor");
 
@@ -4320,7 +4631,7 @@ stepmoveresult_t Actor::TryMove(void)
             door = static_cast<Door *>(ent);
             if(!door->locked && !door->isOpen())
             {
-               SetVariable("other", ent);
+               SetVariable(otherVar, ent);
                SetVariable("dir", end - worldorigin);
                ForceAction("opendoor");
 
@@ -4666,13 +4977,13 @@ void Actor::ShowInfo(void)
    for(i = 1; i <= n; i++)
    {
       ptr = actionList.ObjectAt(i);
-      gi.printf("%s : ", ptr->action.c_str());
+      gi.printf("%s : ", G_ActionName(ptr->action));
       if(ptr->ignore)
       {
          gi.printf("ignored - ");
       }
 
-      gi.printf("%s\n", ptr->response.c_str());
+      gi.printf("%s\n", ptr->response);
    }
 
    n = enemyList.NumObjects();
@@ -4760,7 +5071,7 @@ void Actor::ActivateEvent(Event *ev)
    }
 
    ent = ev->GetEntity(1);
-   SetVariable("other", ent);
+   SetVariable(otherVar, ent);
 
    DoAction("activate");
 }
@@ -4775,7 +5086,7 @@ void Actor::UseEvent(Event *ev)
    }
 
    ent = ev->GetEntity(1);
-   SetVariable("other", ent);
+   SetVariable(otherVar, ent);
 
    DoAction("use");
 }
@@ -4825,7 +5136,7 @@ void Actor::Prethink()
    {
       if(currentEnemy->deadflag)
       {
-         DoAction("enemydead");
+         DoAction(actionEnemyDead);
          currentEnemy = nullptr;
          seenEnemy = false;
       }
@@ -4837,23 +5148,23 @@ void Actor::Prethink()
             lastEnemy = currentEnemy;
             enemyRange = range;
 
-            SetVariable("other", currentEnemy);
+            SetVariable(otherVar, currentEnemy);
             switch(range)
             {
             case RANGE_MELEE:
-               DoAction("range_melee");
+               DoAction(actionRangeMelee);
                break;
 
             case RANGE_NEAR:
-               DoAction("range_near");
+               DoAction(actionRangeNear);
                break;
 
             case RANGE_MID:
-               DoAction("range_mid");
+               DoAction(actionRangeMid);
                break;
 
             case RANGE_FAR:
-               DoAction("range_far");
+               DoAction(actionRangeFar);
                break;
             }
          }
@@ -108,14 +108,24 @@ typedef enum
 //#define DAMAGE_WEIGHT 0.5   // If he's done a lot of damage to you
 //#define WEAPON_WEIGHT 1.5   // How much the weapon influences you
 
+//
+// Action names are registered once and referred to by number from then on.
+// Numbers start at 1 and are only good for the life of the dll, so they're
+// never saved.
+//
+int         G_ActionNum(const char *name);
+const char *G_ActionName(int action);
+int         G_NumActions(void);
+
 class EXPORT_FROM_DLL StateInfo : public Class
 {
 public:
    CLASS_PROTOTYPE(StateInfo);
 
-   str      action;
-   str      response;
-   qboolean ignore = true;
+   int                  action   = 0;      // from G_ActionNum
+   const char          *response = "";     // interned
+   qboolean             ignore   = true;
+   scriptlabelref_t     label    = {};     // response, once it's been jumped to
 
    virtual void         Archive(Archiver &arc)   override;
    virtual void         Unarchive(Archiver &arc) override;
@@ -123,19 +133,27 @@ public:
 
 inline EXPORT_FROM_DLL void StateInfo::Archive(Archiver &arc)
 {
+   str text;
+
    Class::Archive(arc);
 
-   arc.WriteString(action);
-   arc.WriteString(response);
+   text = G_ActionName(action);
+   arc.WriteString(text);
+   text = response;
+   arc.WriteString(text);
    arc.WriteBoolean(ignore);
 }
 
 inline EXPORT_FROM_DLL void StateInfo::Unarchive(Archiver &arc)
 {
+   str text;
+
    Class::Unarchive(arc);
 
-   arc.ReadString(&action);
-   arc.ReadString(&response);
+   arc.ReadString(&text);
+   action = G_ActionNum(text.c_str());
+   arc.ReadString(&text);
+   response = G_InternScriptString(text.c_str());
    arc.ReadBoolean(&ignore);
 }
 
@@ -226,6 +244,7 @@ inline EXPORT_FROM_DLL void ActorState::Unarchive(Archiver &arc)
 //
 #ifdef EXPORT_TEMPLATE
 template class EXPORT_FROM_DLL Container<EntityPtr>;
+template class EXPORT_FROM_DLL Container<EntityHandle>;
 template class EXPORT_FROM_DLL Stack<ActorState *>;
 #endif
 
@@ -253,6 +272,8 @@ public:
    str                        state;
    str                        animname;
    Container<StateInfo *>     actionList;
+   StateInfo                **actionTable     = nullptr;   // actionList indexed by action number
+   int                        actionTableSize = 0;
    int                        numonstack;
    Stack<ActorState *>        stateStack;
 
@@ -261,9 +282,9 @@ public:
 
    PathPtr                    path;
 
-   Container<EntityPtr>       targetList;
-   Container<EntityPtr>       nearbyList;
-   Container<EntityPtr>       enemyList;
+   Container<EntityHandle>    targetList;
+   Container<EntityHandle>    nearbyList;
+   Container<EntityHandle>    enemyList;
    EntityPtr                  currentEnemy;
    qboolean                   seenEnemy;
    range_t                    enemyRange;
@@ -293,6 +314,11 @@ public:
    ThreadPtr                  thread;
 
    ThreadPtr                  actorthread;
+
+   // variables on actorthread that get set on every action, not archived
+   ScriptVariableSlot         stateVar = ScriptVariableSlot("state");
+   ScriptVariableSlot         otherVar = ScriptVariableSlot("other");
+
    str                        actorscript;
    str                        actorstart;
    TouchFieldPtr              trig;
@@ -330,6 +356,7 @@ public:
    qboolean                   InFOV(Entity *ent);
    qboolean                   CanSeeFOV(Entity *ent);
    qboolean                   CanSeeFrom(Vector pos, Entity *ent);
+   int                        CanSeeFromCount(const Vector *positions, int num, Entity *ent);
    qboolean                   CanSee(Entity *ent);
    int                        EnemyCanSeeMeFrom(Vector pos);
    qboolean                   CanSeeEnemyFrom(Vector pos);
@@ -373,6 +400,9 @@ public:
    StateInfo                  *SetResponse(str action, str response, qboolean ignore = false);
    const char                 *GetResponse(str action, qboolean force = false);
    StateInfo                  *GetState(str action);
+   StateInfo                  *GetState(int action);
+   void                       LinkAction(StateInfo *ptr);
+   void                       BuildActionTable(void);
 
    // State stack management
    void                       ClearStateStack(void);
@@ -393,6 +423,7 @@ public:
    // Thread management
    void                       SetupThread(void);
    qboolean                   DoAction(str name, qboolean force = false);
+   qboolean                   DoAction(int action, qboolean force = false);
    qboolean                   ForceAction(str name);
    void                       ProcessScript(ScriptThread *thread, Event *ev = NULL);
    void                       StartMove(Event *ev);
@@ -402,6 +433,8 @@ public:
    ScriptVariable             *SetVariable(const char *name, str &text);
    ScriptVariable             *SetVariable(const char *name, Entity *ent);
    ScriptVariable             *SetVariable(const char *name, Vector &vec);
+   ScriptVariable             *SetVariable(ScriptVariableSlot &slot, const char *text);
+   ScriptVariable             *SetVariable(ScriptVariableSlot &slot, Entity *ent);
 
    // Thread based script commands
    void                       SetScript(Event *ev);
@@ -711,6 +744,7 @@ inline EXPORT_FROM_DLL void Actor::Unarchive(Archiver &arc)
       arc.ReadObject(info);
       actionList.AddObject(info);
    }
+   BuildActionTable();
 
    arc.ReadInteger(&numonstack);
 
@@ -738,7 +772,7 @@ inline EXPORT_FROM_DLL void Actor::Unarchive(Archiver &arc)
    targetList.Resize(num);
    for(i = 1; i <= num; i++)
    {
-      EntityPtr tmp, *ptr;
+      EntityHandle tmp, *ptr;
 
       targetList.AddObject(tmp);
       ptr = targetList.AddressOfObjectAt(i);
@@ -750,7 +784,7 @@ inline EXPORT_FROM_DLL void Actor::Unarchive(Archiver &arc)
    nearbyList.Resize(num);
    for(i = 1; i <= num; i++)
    {
-      EntityPtr tmp, *ptr;
+      EntityHandle tmp, *ptr;
 
       nearbyList.AddObject(tmp);
       ptr = nearbyList.AddressOfObjectAt(i);
@@ -762,7 +796,7 @@ inline EXPORT_FROM_DLL void Actor::Unarchive(Archiver &arc)
    enemyList.Resize(num);
    for(i = 1; i <= num; i++)
    {
-      EntityPtr tmp, *ptr;
+      EntityHandle tmp, *ptr;
 
       enemyList.AddObject(tmp);
       ptr = enemyList.AddressOfObjectAt(i);
@@ -246,6 +246,19 @@ void Archiver::Close(void)
             fixupptr = (SafePtrBase *)fixup->ptr;
             fixupptr->InitSafePtr(classptr);
          }
+         else if(fixup->type == pointer_fixup_handle)
+         {
+            EntityHandle * fixupptr;
+            fixupptr = (EntityHandle *)fixup->ptr;
+            if(classptr && classptr->isSubclassOf<Entity>())
+            {
+               *fixupptr = (Entity *)classptr;
+            }
+            else
+            {
+               *fixupptr = nullptr;
+            }
+         }
          delete fixup;
       }
       fixupList.FreeObjectList();
@@ -507,6 +520,38 @@ void Archiver::ReadSafePointer(SafePtrBase * ptr)
    }
 }
 
+//
+// Handles are written with WriteSafePointer, so they can be read back into 
+// either a handle or an EntityPtr.
+//
+void Archiver::ReadSafePointer(EntityHandle * ptr)
+{
+   int index;
+   pointer_fixup_t *fixup;
+
+   ReadData(ARC_SafePointer, &index, sizeof(index));
+
+   // Check for a NULL pointer
+   assert(ptr);
+   if(!ptr)
+   {
+      FileError("NULL pointer in ReadSafePointer.");
+   }
+
+   // init the handle with NULL until we can fix it
+   *ptr = nullptr;
+
+   if(index != ARCHIVE_NULL_POINTER)
+   {
+      // Add new fixup
+      fixup = new pointer_fixup_t();
+      fixup->ptr = (void **)ptr;
+      fixup->index = index;
+      fixup->type = pointer_fixup_handle;
+      fixupList.AddObject(fixup);
+   }
+}
+
 Event Archiver::ReadEvent(void)
 {
    Event ev;
@@ -30,9 +30,12 @@
 enum
 {
    pointer_fixup_normal,
-   pointer_fixup_safe
+   pointer_fixup_safe,
+   pointer_fixup_handle
 };
 
+class EntityHandle;
+
 typedef struct
 {
    void **ptr;
@@ -132,6 +135,7 @@ public:
    void           ReadString(str * string);
    void           ReadObjectPointer(Class ** ptr);
    void           ReadSafePointer(SafePtrBase * ptr);
+   void           ReadSafePointer(EntityHandle * ptr);
    void           ReadEvent(Event * ev);
 
    void           ReadRaw(void *data, size_t size);
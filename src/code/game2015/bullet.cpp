@@ -203,6 +203,24 @@ void BulletWeapon::TraceAttack(Vector start, Vector end, int damage, trace_t *tr
    }
 }
 
+#define BULLET_BATCH 16
+
+//###
+static qboolean HitHoverbike(trace_t *trace)
+{
+   Entity *hit;
+
+   if(trace->fraction == 1)
+   {
+      return false;
+   }
+
+   hit = trace->ent->entity;
+
+   return hit->isSubclassOf<Hoverbike>() || hit->isSubclassOf<HoverbikeBox>();
+}
+//###
+
 void BulletWeapon::FireBullets(int numbullets, Vector spread, int mindamage, int maxdamage, int dflags, int meansofdeath, qboolean server_effects)
 {
    Vector	src;
@@ -212,6 +230,15 @@ void BulletWeapon::FireBullets(int numbullets, Vector spread, int mindamage, int
    Vector	right;
    Vector	up;
    int		i;
+   int      j;
+   int      num;
+   int      numfull;
+   unsigned generation;
+   qboolean bboxbullets;
+   Vector         ends[BULLET_BATCH];
+   tracerequest_t requests[BULLET_BATCH];
+   trace_t        results[BULLET_BATCH];
+   trace_t        fullresults[BULLET_BATCH];
 
    assert(owner);
    if(!owner)
@@ -226,25 +253,66 @@ void BulletWeapon::FireBullets(int numbullets, Vector spread, int mindamage, int
    angles = dir.toAngles();
    setAngles(angles);
 
-   for(i = 0; i < numbullets; i++)
+   bboxbullets = !damagedtarget && DM_FLAG(DF_BBOX_BULLETS); //###
+
+   for(i = 0; i < numbullets; i += num)
    {
-      end = src +
-         dir   * 8192 +
-         right * G_CRandom() * spread.x +
-         up    * G_CRandom() * spread.y;
-      
-      //### first need to do a regular trace to check for hitting a hoverbike
-      trace = G_Trace(src, vec_zero, vec_zero, end, owner, MASK_SHOT, "BulletWeapon::FireBullets");
-      if(trace.fraction != 1)
+      // aim a batch of bullets and do their traces all at once
+      num = numbullets - i;
+      if(num > BULLET_BATCH)
+      {
+         num = BULLET_BATCH;
+      }
+
+      for(j = 0; j < num; j++)
+      {
+         ends[j] = src +
+            dir   * 8192 +
+            right * G_CRandom() * spread.x +
+            up    * G_CRandom() * spread.y;
+         G_SetTraceRequest(&requests[j], src, vec_zero, vec_zero, ends[j], owner, MASK_SHOT, "BulletWeapon::FireBullets");
+      }
+
+      G_TraceBatch(requests, results, num);
+
+      // the full traces are the expensive ones.  Firing stops at the first
+      // bullet that hits a hoverbike, so only the ones before it need them.
+      numfull = 0;
+      if(!bboxbullets)
+      {
+         while((numfull < num) && !HitHoverbike(&results[numfull]))
+         {
+            G_SetFullTraceRequest(&requests[numfull], src, vec_zero, vec_zero, ends[numfull], 5, owner, MASK_SHOT, "BulletWeapon::FireBullets");
+            numfull++;
+         }
+
+         G_TraceBatch(requests, fullresults, numfull);
+      }
+
+      generation = G_TraceGeneration();
+
+      for(j = 0; j < num; j++)
       {
-         Entity *hit;
+         end = ends[j];
 
-         hit = trace.ent->entity;
+         //### first need to do a regular trace to check for hitting a hoverbike
+         if(G_TraceGeneration() == generation)
+         {
+            trace = results[j];
+         }
+         else
+         {
+            // an earlier bullet changed what's out there, so trace it again
+            trace = G_Trace(src, vec_zero, vec_zero, end, owner, MASK_SHOT, "BulletWeapon::FireBullets");
+         }
 
-         if(hit->isSubclassOf<Hoverbike>() || hit->isSubclassOf<HoverbikeBox>())
+         if(HitHoverbike(&trace))
          {
+            Entity *hit;
             trace_t trace2;
 
+            hit = trace.ent->entity;
+
             // also do a short full trace to see if we're hitting a player on a hoverbike
             end = trace.endpos + dir * 80;
             trace2 = G_FullTrace(Vector(trace.endpos), vec_zero, vec_zero, end, 5, owner, MASK_SHOT, "BulletWeapon::FireBullets");
@@ -267,38 +335,44 @@ void BulletWeapon::FireBullets(int numbullets, Vector spread, int mindamage, int
 
             return; // hit something already, so don't do a regular full trace
          }
-      }
-
-      if(!damagedtarget && DM_FLAG(DF_BBOX_BULLETS))
-      {
-         trace = G_Trace(src, vec_zero, vec_zero, end, owner, MASK_SHOT, "BulletWeapon::FireBullets");
 
-         if(trace.fraction != 1.0)
+         if(bboxbullets)
          {
-            // do less than regular damage on a bbox hit
-            TraceAttack(src, trace.endpos, (mindamage + (int)G_Random(maxdamage - mindamage + 1))*0.85, &trace, 
-                        MAX_RICOCHETS, kick, dflags, meansofdeath, server_effects);
+            // nothing has happened since the first trace, so it's still good
+            if(trace.fraction != 1.0)
+            {
+               // do less than regular damage on a bbox hit
+               TraceAttack(src, trace.endpos, (mindamage + (int)G_Random(maxdamage - mindamage + 1))*0.85, &trace, 
+                           MAX_RICOCHETS, kick, dflags, meansofdeath, server_effects);
+            }
          }
-      }
-      else
-      { //###
-         trace = G_FullTrace(src, vec_zero, vec_zero, end, 5, owner, MASK_SHOT, "BulletWeapon::FireBullets");
+         else
+         { //###
+            if((j < numfull) && (G_TraceGeneration() == generation))
+            {
+               trace = fullresults[j];
+            }
+            else
+            {
+               trace = G_FullTrace(src, vec_zero, vec_zero, end, 5, owner, MASK_SHOT, "BulletWeapon::FireBullets");
+            }
 #if 0
-         Com_Printf("Server OWNER  Angles:%0.2f %0.2f %0.2f\n", owner->angles[0], owner->angles[1], owner->angles[2]);
-         Com_Printf("Server Bullet Angles:%0.2f %0.2f %0.2f\n", angles[0], angles[1], angles[2]);
-         Com_Printf("Right               :%0.2f %0.2f %0.2f\n", right[0], right[1], right[2]);
-         Com_Printf("Up                  :%0.2f %0.2f %0.2f\n", up[0], up[1], up[2]);
-         Com_Printf("Direction           :%0.2f %0.2f %0.2f\n", dir[0], dir[1], dir[2]);
-         Com_Printf("Endpoint            :%0.2f %0.2f %0.2f\n", end[0], end[1], end[2]);
-         Com_Printf("Server Trace Start  :%0.2f %0.2f %0.2f\n", src[0], src[1], src[2]);
-         Com_Printf("Server Trace End    :%0.2f %0.2f %0.2f\n", trace.endpos[0], trace.endpos[1], trace.endpos[2]);
-         Com_Printf("\n");
+            Com_Printf("Server OWNER  Angles:%0.2f %0.2f %0.2f\n", owner->angles[0], owner->angles[1], owner->angles[2]);
+            Com_Printf("Server Bullet Angles:%0.2f %0.2f %0.2f\n", angles[0], angles[1], angles[2]);
+            Com_Printf("Right               :%0.2f %0.2f %0.2f\n", right[0], right[1], right[2]);
+            Com_Printf("Up                  :%0.2f %0.2f %0.2f\n", up[0], up[1], up[2]);
+            Com_Printf("Direction           :%0.2f %0.2f %0.2f\n", dir[0], dir[1], dir[2]);
+            Com_Printf("Endpoint            :%0.2f %0.2f %0.2f\n", end[0], end[1], end[2]);
+            Com_Printf("Server Trace Start  :%0.2f %0.2f %0.2f\n", src[0], src[1], src[2]);
+            Com_Printf("Server Trace End    :%0.2f %0.2f %0.2f\n", trace.endpos[0], trace.endpos[1], trace.endpos[2]);
+            Com_Printf("\n");
 #endif
-         if(trace.fraction != 1.0)
-         {
-            TraceAttack(src, trace.endpos, mindamage + (int)G_Random(maxdamage - mindamage + 1), &trace, MAX_RICOCHETS, kick, dflags, meansofdeath, server_effects);
-         }
-      } // ###
+            if(trace.fraction != 1.0)
+            {
+               TraceAttack(src, trace.endpos, mindamage + (int)G_Random(maxdamage - mindamage + 1), &trace, MAX_RICOCHETS, kick, dflags, meansofdeath, server_effects);
+            }
+         } // ###
+      }
    }
 }
 
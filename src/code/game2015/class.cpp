@@ -23,12 +23,36 @@
 #include "g_local.h"
 #include "class.h"
 #include "linklist.h"
-
-int totalmemallocated = 0;
-int numclassesallocated = 0;
+#include "../elib/qstring.h"
 
 static ClassDef *classlist = nullptr;
 
+// Classes hashed by name and by id.  These are plain arrays so that they're 
+// zeroed before any of the static ClassDefs get constructed.
+#define CLASS_HASH_SIZE 1024
+
+static ClassDef *classNameHash[CLASS_HASH_SIZE];
+static ClassDef *classIDHash[CLASS_HASH_SIZE];
+
+static inline int ClassHashKey(const char *name)
+{
+   return qstring::HashCodeStatic(name) & (CLASS_HASH_SIZE - 1);
+}
+
+static void UnlinkClassHash(ClassDef **chain, ClassDef *cls, ClassDef *ClassDef::*link)
+{
+   while(*chain)
+   {
+      if(*chain == cls)
+      {
+         *chain = cls->*link;
+         cls->*link = nullptr;
+         return;
+      }
+      chain = &((*chain)->*link);
+   }
+}
+
 ClassDef::ClassDef()
 {
    this->prev = this;
@@ -48,7 +72,7 @@ ClassDef::ClassDef(const char *classname, const char *classID, const char *super
    this->superclass     = superclass;
    this->responses      = responses;
    this->numEvents      = 0;
-   this->responseLookup = nullptr;
+   this->responsePages  = nullptr;
    this->newInstance    = newInstance;
    this->classSize      = classSize;
    this->super          = getClass(superclass);
@@ -72,6 +96,19 @@ ClassDef::ClassDef(const char *classname, const char *classID, const char *super
 
    // Add to front of list
    LL_Add(classlist, this, prev, next);
+
+   // Add to the front of the hash chains too, so that lookups find the same
+   // class that a walk of the list would.
+   int key = ClassHashKey(this->classname);
+   this->nameHashNext = classNameHash[key];
+   classNameHash[key] = this;
+
+   if(this->classID[0])
+   {
+      key = ClassHashKey(this->classID);
+      this->idHashNext = classIDHash[key];
+      classIDHash[key] = this;
+   }
 }
 
 ClassDef::~ClassDef()
@@ -82,6 +119,12 @@ ClassDef::~ClassDef()
    {
       LL_Remove(this, prev, next);
 
+      UnlinkClassHash(&classNameHash[ClassHashKey(classname)], this, &ClassDef::nameHashNext);
+      if(classID[0])
+      {
+         UnlinkClassHash(&classIDHash[ClassHashKey(classID)], this, &ClassDef::idHashNext);
+      }
+
       // Check if any subclasses were initialized before their superclass
       for(node = classlist->next; node != classlist; node = node->next)
       {
@@ -97,38 +140,136 @@ ClassDef::~ClassDef()
       assert(this->next == this->prev);
    }
 
-   if(responseLookup)
+   if(responsePages)
    {
-      delete [] responseLookup;
-      responseLookup = nullptr;
+      delete [] reinterpret_cast<char *>(responsePages);
+      responsePages = nullptr;
    }
 }
 
+// Shared by every page that no class in the chain responds to
+static Response *nullResponsePage[RESPONSE_PAGE_SIZE];
+
+//
+// Must be called after the superclass has been built, since any page that
+// this class doesn't add responses to is shared with the superclass.
+//
 EXPORT_FROM_DLL void ClassDef::BuildResponseList()
 {
-   const ClassDef *c;
    ResponseDef    *r;
+   Response      **shared;
+   Response      **page;
    int             ev;
    int             i;
+   int             p;
    qboolean       *set;
+   qboolean       *owned;
    int             num;
+   int             numpages;
 
-   if(responseLookup)
+   if(responsePages)
    {
-      delete [] responseLookup;
-      responseLookup = nullptr;
+      delete [] reinterpret_cast<char *>(responsePages);
+      responsePages = nullptr;
    }
 
    num = Event::NumEventCommands();
-   responseLookup = reinterpret_cast<Response **>(new char[sizeof(Response *) * num]);
-   memset(responseLookup, 0, sizeof(Response *) * num);
+   numpages = (num + RESPONSE_PAGE_MASK) >> RESPONSE_PAGE_BITS;
+
+   assert(!super || (super->numEvents == num));
+
+   // find out which pages our own responses land in
+   owned = new qboolean [numpages];
+   memset(owned, 0, sizeof(qboolean) * numpages);
+
+   numOwnedPages = 0;
+   r = responses;
+   if(r)
+   {
+      for(i = 0; r[i].event != nullptr; i++)
+      {
+         p = (int)*r[i].event >> RESPONSE_PAGE_BITS;
+         if(!owned[p])
+         {
+            owned[p] = true;
+            numOwnedPages++;
+         }
+      }
+   }
+
+   // the page directory and the pages we own are allocated as one block
+   responsePages = reinterpret_cast<Response ***>(new char[sizeof(Response **) * numpages + 
+      sizeof(Response *) * RESPONSE_PAGE_SIZE * numOwnedPages]);
+   page = reinterpret_cast<Response **>(responsePages + numpages);
 
+   for(p = 0; p < numpages; p++)
+   {
+      shared = super ? super->responsePages[p] : nullResponsePage;
+      if(owned[p])
+      {
+         memcpy(page, shared, sizeof(Response *) * RESPONSE_PAGE_SIZE);
+         responsePages[p] = page;
+         page += RESPONSE_PAGE_SIZE;
+      }
+      else
+      {
+         responsePages[p] = shared;
+      }
+   }
+
+   this->numEvents = num;
+
+   // the first response for an event overrides any others
    set = new qboolean [num];
    memset(set, 0, sizeof(qboolean) * num);
 
-   this->numEvents = num;
+   if(r)
+   {
+      for(i = 0; r[i].event != nullptr; i++)
+      {
+         ev = (int)*r[i].event;
+         if(!set[ev])
+         {
+            set[ev] = true;
+            if(r[i].response)
+            {
+               responsePages[ev >> RESPONSE_PAGE_BITS][ev & RESPONSE_PAGE_MASK] = &r[i].response;
+            }
+            else
+            {
+               responsePages[ev >> RESPONSE_PAGE_BITS][ev & RESPONSE_PAGE_MASK] = nullptr;
+            }
+         }
+      }
+   }
+
+   delete [] set;
+   delete [] owned;
+}
+
+#ifndef NDEBUG
+
+//
+// Builds the full width table the way we used to and makes sure that the 
+// paged table dispatches every event the same way.
+//
+static void VerifyResponseList(const ClassDef *cls)
+{
+   const ClassDef *c;
+   ResponseDef    *r;
+   Response      **lookup;
+   qboolean       *set;
+   int             ev;
+   int             i;
+   int             num;
 
-   for(c = this; c != nullptr; c = c->super)
+   num = cls->numEvents;
+   lookup = new Response *[num];
+   memset(lookup, 0, sizeof(Response *) * num);
+   set = new qboolean [num];
+   memset(set, 0, sizeof(qboolean) * num);
+
+   for(c = cls; c != nullptr; c = c->super)
    {
       r = c->responses;
       if(r)
@@ -139,49 +280,141 @@ EXPORT_FROM_DLL void ClassDef::BuildResponseList()
             if(!set[ev])
             {
                set[ev] = true;
-               if(r[i].response)
-               {
-                  responseLookup[ev] = &r[i].response;
-               }
-               else
-               {
-                  responseLookup[ev] = nullptr;
-               }
+               lookup[ev] = r[i].response ? &r[i].response : nullptr;
             }
          }
       }
    }
 
+   for(ev = 0; ev < num; ev++)
+   {
+      if(cls->GetResponse(ev) != lookup[ev])
+      {
+         gi.error("Response table for class '%s' doesn't match on event %d\n", cls->classname, ev);
+      }
+   }
+
    delete [] set;
+   delete [] lookup;
+}
+
+#endif
+
+//
+// Numbers the class tree in a depth first walk so that checkInheritance 
+// only has to compare two numbers instead of walking the superclass chain.
+//
+static int NumberClassTree(ClassDef *c, int num)
+{
+   ClassDef *child;
+
+   c->treePre = ++num;
+   for(child = c->firstChild; child != nullptr; child = child->nextSibling)
+   {
+      num = NumberClassTree(child, num);
+   }
+   c->treePost = ++num;
+
+   return num;
+}
+
+static void NumberClassTree()
+{
+   ClassDef *c;
+   ClassDef *super;
+   int       num;
+
+   for(c = classlist->next; c != classlist; c = c->next)
+   {
+      c->firstChild = nullptr;
+      c->nextSibling = nullptr;
+   }
+
+   for(c = classlist->next; c != classlist; c = c->next)
+   {
+      if(c->super)
+      {
+         super = const_cast<ClassDef *>(c->super);
+         c->nextSibling = super->firstChild;
+         super->firstChild = c;
+      }
+   }
+
+   num = 0;
+   for(c = classlist->next; c != classlist; c = c->next)
+   {
+      if(!c->super)
+      {
+         num = NumberClassTree(c, num);
+      }
+   }
+}
+
+//
+// Builds the response tables down the class tree so that every class is 
+// built after its superclass.
+//
+static void BuildClassResponses(ClassDef *c)
+{
+   ClassDef *child;
+
+   c->BuildResponseList();
+   for(child = c->firstChild; child != nullptr; child = child->nextSibling)
+   {
+      BuildClassResponses(child);
+   }
 }
 
 EXPORT_FROM_DLL void BuildEventResponses()
 {
    ClassDef *c;
    int amount;
+   int fullwidth;
    int numclasses;
+   int numpages;
+
+   NumberClassTree();
+
+   for(c = classlist->next; c != classlist; c = c->next)
+   {
+      if(!c->super)
+      {
+         BuildClassResponses(c);
+      }
+   }
 
    amount = 0;
+   fullwidth = 0;
    numclasses = 0;
+   numpages = (Event::NumEventCommands() + RESPONSE_PAGE_MASK) >> RESPONSE_PAGE_BITS;
    for(c = classlist->next; c != classlist; c = c->next)
    {
-      c->BuildResponseList();
+#ifndef NDEBUG
+      VerifyResponseList(c);
+#endif
 
-      amount += c->numEvents * sizeof(Response *);
+      amount += numpages * sizeof(Response **) + c->numOwnedPages * RESPONSE_PAGE_SIZE * sizeof(Response *);
+      fullwidth += c->numEvents * sizeof(Response *);
       numclasses++;
    }
 
    gi.dprintf("\n------------------\n"
               "Event system initialized:\n"
-              "%d classes\n%d events\n%d total memory in response list\n\n",
-              numclasses, Event::NumEventCommands(), amount);
+              "%d classes\n%d events\n%d total memory in response list\n"
+              "%d saved over full width response lists\n\n",
+              numclasses, Event::NumEventCommands(), amount, fullwidth - amount);
 }
 
 EXPORT_FROM_DLL const ClassDef *getClassForID(const char *name)
 {
-   for(const ClassDef *c = classlist->next; c != classlist; c = c->next)
+   if(!name || !name[0])
    {
-      if(c->classID && !Q_stricmp(c->classID, name))
+      return nullptr;
+   }
+
+   for(const ClassDef *c = classIDHash[ClassHashKey(name)]; c != nullptr; c = c->idHashNext)
+   {
+      if(!Q_stricmp(c->classID, name))
       {
          return c;
       }
@@ -192,7 +425,12 @@ EXPORT_FROM_DLL const ClassDef *getClassForID(const char *name)
 
 EXPORT_FROM_DLL const ClassDef *getClass(const char *name)
 {
-   for(const ClassDef *c = classlist->next; c != classlist; c = c->next)
+   if(!name)
+   {
+      return nullptr;
+   }
+
+   for(const ClassDef *c = classNameHash[ClassHashKey(name)]; c != nullptr; c = c->nameHashNext)
    {
       if(!Q_stricmp(c->classname, name))
       {
@@ -232,6 +470,18 @@ EXPORT_FROM_DLL void listInheritanceOrder(const char *classname)
 
 EXPORT_FROM_DLL qboolean checkInheritance(const ClassDef *superclass, const ClassDef *subclass)
 {
+   if(!superclass || !subclass)
+   {
+      return false;
+   }
+
+   // Once the tree is numbered, a subclass sits inside its superclass's range
+   if(superclass->treePre && subclass->treePre)
+   {
+      return (subclass->treePre >= superclass->treePre) && (subclass->treePost <= superclass->treePost);
+   }
+
+   // Still starting up, so walk the chain
    for(const ClassDef *c = subclass; c != nullptr; c = c->super)
    {
       if(c == superclass)
@@ -278,67 +528,293 @@ ResponseDef Class::Responses[] =
    { nullptr, nullptr }
 };
 
-#ifdef NDEBUG
+/***********************************************************************
+
+  Class allocation
+
+***********************************************************************/
+
+#define CLASS_SLAB_GRANULARITY  16
+#define CLASS_SLAB_MAXSIZE      8192
+#define CLASS_SLAB_BLOCKSIZE    65536
+#define CLASS_SLAB_MINITEMS     8
+
+#define CLASS_ROUND(s) (((s) + CLASS_SLAB_GRANULARITY - 1) & ~(CLASS_SLAB_GRANULARITY - 1))
 
-EXPORT_FROM_DLL void *Class::operator new (size_t s)
+typedef struct classblock_s
 {
-   int *p;
+   struct classblock_s *next;
+   classslab_t         *slab;
+   int                  numused;
+} classblock_t;
+
+// Sits in front of every object.  Free items keep their header and use the 
+// start of the object for the free list link.
+typedef struct classitem_s
+{
+#ifndef NDEBUG
+   int                  guard;
+#endif
+   int                  size;    // size of the whole allocation
+   classblock_t        *block;   // nullptr when too big for a slab
+} classitem_t;
+
+#ifdef NDEBUG
+#define CLASS_TRAILER   0
+#else
+#define CLASS_TRAILER   sizeof(int)
+#endif
+
+#define CLASS_BLOCK_HEADER CLASS_ROUND(sizeof(classblock_t))
 
-   s += sizeof(int);
-   p = reinterpret_cast<int *>(::new char [s]);
-   memset(p, 0, s);
-   *p = s;
-   totalmemallocated += s;
-   numclassesallocated++;
-   return p + 1;
+static classslab_t *slablist = nullptr;
+static classslab_t *sizeslabs[CLASS_SLAB_MAXSIZE / CLASS_SLAB_GRANULARITY + 1];
+
+static inline classitem_t *&NextFreeItem(classitem_t *item)
+{
+   return *reinterpret_cast<classitem_t **>(item + 1);
 }
 
-EXPORT_FROM_DLL void Class::operator delete (void *ptr)
+static classslab_t *ClassSlabForSize(size_t s)
 {
-   int *p;
+   int index;
+
+   if(s > CLASS_SLAB_MAXSIZE)
+   {
+      return nullptr;
+   }
+
+   index = CLASS_ROUND(s) / CLASS_SLAB_GRANULARITY;
+   if(!sizeslabs[index])
+   {
+      sizeslabs[index] = new classslab_t;
+      memset(sizeslabs[index], 0, sizeof(classslab_t));
+      sizeslabs[index]->objsize = index * CLASS_SLAB_GRANULARITY;
+   }
 
-   p = (reinterpret_cast<int *>(ptr)) - 1;
-   totalmemallocated -= *p;
-   numclassesallocated--;
-   ::delete [] (p);
+   return sizeslabs[index];
 }
 
-#else
+static void AllocClassBlock(classslab_t *slab)
+{
+   classblock_t *block;
+   classitem_t  *item;
+   byte         *p;
+   int           i;
+
+   // first block for this slab
+   if(!slab->itemsize)
+   {
+      slab->itemsize = CLASS_ROUND(sizeof(classitem_t) + slab->objsize + CLASS_TRAILER);
+      slab->itemsperblock = (CLASS_SLAB_BLOCKSIZE - CLASS_BLOCK_HEADER) / slab->itemsize;
+      if(slab->itemsperblock < CLASS_SLAB_MINITEMS)
+      {
+         slab->itemsperblock = CLASS_SLAB_MINITEMS;
+      }
+
+      slab->next = slablist;
+      slablist = slab;
+   }
+
+   p = ::new byte[CLASS_BLOCK_HEADER + slab->itemsize * slab->itemsperblock];
+   block = reinterpret_cast<classblock_t *>(p);
+   block->slab = slab;
+   block->numused = 0;
+   block->next = slab->blocks;
+   slab->blocks = block;
+   slab->numblocks++;
+
+   p += CLASS_BLOCK_HEADER;
+   for(i = slab->itemsperblock - 1; i >= 0; i--)
+   {
+      item = reinterpret_cast<classitem_t *>(p + slab->itemsize * i);
+      item->size = slab->itemsize;
+      item->block = block;
+      NextFreeItem(item) = slab->freelist;
+      slab->freelist = item;
+   }
+}
 
-EXPORT_FROM_DLL void * Class::operator new (size_t s)
+EXPORT_FROM_DLL void *AllocClassObject(size_t s, ClassDef *cls)
 {
-   int *p;
+   classslab_t *slab;
+   classitem_t *item;
+   int          size;
+
+   // Subclasses that don't declare themselves with CLASS_PROTOTYPE come 
+   // through here with their superclass's ClassDef, so check the size.
+   slab = cls->slab;
+   if(!slab || (s > (size_t)slab->objsize))
+   {
+      slab = ClassSlabForSize(s);
+      if(!cls->slab && (s == (size_t)cls->classSize))
+      {
+         cls->slab = slab;
+      }
+   }
+
+   if(slab)
+   {
+      if(!slab->freelist)
+      {
+         AllocClassBlock(slab);
+      }
+
+      item = slab->freelist;
+      slab->freelist = NextFreeItem(item);
+      item->block->numused++;
 
-   s += sizeof(int) * 3;
-   p = reinterpret_cast<int *>(::new char [s]);
-   memset(p, 0, s);
-   p[0] = 0x12348765;
-   *reinterpret_cast<int *>((reinterpret_cast<byte *>(p)) + s - sizeof(int)) = 0x56784321;
-   p[1] = s;
-   totalmemallocated += s;
-   numclassesallocated++;
-   return p + 2;
+      slab->allocs++;
+      slab->inuse++;
+      if(slab->inuse > slab->peak)
+      {
+         slab->peak = slab->inuse;
+      }
+   }
+   else
+   {
+      size = sizeof(classitem_t) + s + CLASS_TRAILER;
+      item = reinterpret_cast<classitem_t *>(::new byte[size]);
+      item->size = size;
+      item->block = nullptr;
+   }
+
+   memset(item + 1, 0, s);
+
+#ifndef NDEBUG
+   item->guard = 0x12348765;
+   *reinterpret_cast<int *>((reinterpret_cast<byte *>(item)) + item->size - sizeof(int)) = 0x56784321;
+#endif
+
+   cls->numLive++;
+   if(cls->numLive > cls->peakLive)
+   {
+      cls->peakLive = cls->numLive;
+   }
+   cls->liveBytes += item->size;
+
+   return item + 1;
 }
 
-EXPORT_FROM_DLL void Class::operator delete (void *ptr)
+EXPORT_FROM_DLL void FreeClassObject(void *ptr, ClassDef *cls)
 {
-   int *p;
+   classitem_t *item;
+   classslab_t *slab;
+
+   if(!ptr)
+   {
+      return;
+   }
+
+   item = (reinterpret_cast<classitem_t *>(ptr)) - 1;
+
+   assert(item->guard == 0x12348765);
+   assert(*reinterpret_cast<int *>((reinterpret_cast<byte *>(item)) + item->size - sizeof(int)) == 0x56784321);
 
-   p = (reinterpret_cast<int *>(ptr)) - 2;
+   cls->numLive--;
+   cls->liveBytes -= item->size;
+
+   if(!item->block)
+   {
+      ::delete [] (reinterpret_cast<byte *>(item));
+      return;
+   }
 
-   assert(p[0] == 0x12348765);
-   assert(*reinterpret_cast<int *>((reinterpret_cast<byte *>(p)) + p[1] - sizeof(int)) == 0x56784321);
+   slab = item->block->slab;
+   item->block->numused--;
+   slab->inuse--;
 
-   totalmemallocated -= p[1];
-   numclassesallocated--;
-   ::delete [] (p);
+   NextFreeItem(item) = slab->freelist;
+   slab->freelist = item;
 }
 
-#endif
+//
+// Gives every block that has nothing left in it back to the heap.  Called 
+// when a level shuts down, once everything from the old level is deleted.
+//
+EXPORT_FROM_DLL void ReleaseClassSlabs()
+{
+   classslab_t   *slab;
+   classitem_t  **item;
+   classblock_t **block;
+   classblock_t  *empty;
+
+   for(slab = slablist; slab != nullptr; slab = slab->next)
+   {
+      // pull the items in the empty blocks out of the free list
+      item = &slab->freelist;
+      while(*item)
+      {
+         if(!(*item)->block->numused)
+         {
+            *item = NextFreeItem(*item);
+         }
+         else
+         {
+            item = &NextFreeItem(*item);
+         }
+      }
 
-EXPORT_FROM_DLL void DisplayMemoryUsage()
+      block = &slab->blocks;
+      while(*block)
+      {
+         if(!(*block)->numused)
+         {
+            empty = *block;
+            *block = empty->next;
+            ::delete [] (reinterpret_cast<byte *>(empty));
+            slab->numblocks--;
+         }
+         else
+         {
+            block = &(*block)->next;
+         }
+      }
+   }
+}
+
+EXPORT_FROM_DLL void DisplayMemoryUsage(qboolean listclasses)
 {
-   gi.printf("Classes %-5d Class memory used: %d\n", numclassesallocated, totalmemallocated);
+   const ClassDef    *c;
+   const classslab_t *slab;
+   int                numobjects;
+   int                total;
+   int                numblocks;
+   int                reserved;
+
+   if(listclasses)
+   {
+      gi.printf("class                              live     peak      bytes\n");
+      gi.printf("------------------------------ -------- -------- ----------\n");
+   }
+
+   numobjects = 0;
+   total = 0;
+   for(c = classlist->next; c != classlist; c = c->next)
+   {
+      if(listclasses && c->peakLive)
+      {
+         gi.printf("%-30s %8d %8d %10d\n", c->classname, c->numLive, c->peakLive, c->liveBytes);
+      }
+
+      numobjects += c->numLive;
+      total += c->liveBytes;
+   }
+
+   numblocks = 0;
+   reserved = 0;
+   for(slab = slablist; slab != nullptr; slab = slab->next)
+   {
+      numblocks += slab->numblocks;
+      reserved += slab->numblocks * (CLASS_BLOCK_HEADER + slab->itemsize * slab->itemsperblock);
+   }
+
+   if(listclasses)
+   {
+      gi.printf("\n");
+   }
+
+   gi.printf("Classes %-5d Class memory used: %d  Slab blocks: %d (%d bytes)\n", numobjects, total, numblocks, reserved);
 }
 
 Class::~Class()
@@ -22,6 +22,7 @@
 #include "g_local.h"
 
 class Class;
+class ClassDef;
 class Event;
 class Archiver;
 
@@ -38,6 +39,30 @@ typedef struct
 
 ***********************************************************************/
 
+// Response tables are split into pages of events.  A class only allocates 
+// the pages that its own response list touches and shares the rest with 
+// its superclass.
+#define RESPONSE_PAGE_BITS 5
+#define RESPONSE_PAGE_SIZE (1 << RESPONSE_PAGE_BITS)
+#define RESPONSE_PAGE_MASK (RESPONSE_PAGE_SIZE - 1)
+
+// Objects are carved out of slabs of same sized items.  Classes that are 
+// about the same size share a slab unless they've been given one of their own.
+typedef struct classslab_s
+{
+   const char          *name;
+   int                  objsize;
+   int                  itemsize;
+   int                  itemsperblock;
+   struct classblock_s *blocks;
+   struct classitem_s  *freelist;
+   int                  numblocks;
+   int                  inuse;
+   int                  peak;
+   int                  allocs;
+   struct classslab_s  *next;
+} classslab_t;
+
 class ClassDef final
 {
 public:
@@ -48,18 +73,44 @@ public:
    int              classSize        = 0;
    ResponseDef     *responses        = nullptr;
    int              numEvents        = 0;
-   Response       **responseLookup   = nullptr;
+   Response      ***responsePages    = nullptr;
+   int              numOwnedPages    = 0;
    const ClassDef  *super            = nullptr;
    ClassDef        *next;
    ClassDef        *prev;
 
+   // Position in a depth first walk of the class tree, set by 
+   // BuildEventResponses.  A class inherits from another when its 
+   // numbers fall within the other's.
+   int              treePre          = 0;
+   int              treePost         = 0;
+   ClassDef        *firstChild       = nullptr;
+   ClassDef        *nextSibling      = nullptr;
+
+   // Hash chains for getClass and getClassForID
+   ClassDef        *nameHashNext     = nullptr;
+   ClassDef        *idHashNext       = nullptr;
+
+   // Allocation info.  These are left out of the initializers so that any
+   // objects allocated before this ClassDef is constructed are still counted.
+   classslab_t     *slab;
+   int              numLive;
+   int              peakLive;
+   int              liveBytes;
+
    ClassDef();
    ~ClassDef();
    ClassDef(const char *classname, const char *classID, const char *superclass,
             ResponseDef *responses, void *(*newInstance)(), int classSize);
    void BuildResponseList();
+   Response *GetResponse(int ev) const;
 };
 
+inline Response *ClassDef::GetResponse(int ev) const
+{
+   return responsePages[ev >> RESPONSE_PAGE_BITS][ev & RESPONSE_PAGE_MASK];
+}
+
 /***********************************************************************
 
   SafePtr
@@ -110,19 +161,26 @@ public:
       return &( nameofclass::ClassInfo );                            \
    }
 
-#define CLASS_PROTOTYPE_BASE( nameofclass )    \
-   public:                                     \
-   static   ClassDef       ClassInfo;          \
-   static   void           *_newInstance();    \
-   virtual  const ClassDef *classinfo() const; \
-   static   ResponseDef    Responses[];
-
-#define CLASS_PROTOTYPE( nameofclass )                  \
-   public:                                              \
-   static   ClassDef       ClassInfo;                   \
-   static   void           *_newInstance();             \
-   virtual  const ClassDef *classinfo() const override; \
-   static   ResponseDef    Responses[];
+void              *AllocClassObject(size_t s, ClassDef *cls);
+void              FreeClassObject(void *ptr, ClassDef *cls);
+
+#define CLASS_PROTOTYPE_BASE( nameofclass )                                     \
+   public:                                                                      \
+   static   ClassDef       ClassInfo;                                           \
+   static   void           *_newInstance();                                     \
+   virtual  const ClassDef *classinfo() const;                                  \
+   static   ResponseDef    Responses[];                                         \
+   void *operator new (size_t s) { return AllocClassObject(s, &ClassInfo); }    \
+   void  operator delete (void *ptr) { FreeClassObject(ptr, &ClassInfo); }
+
+#define CLASS_PROTOTYPE( nameofclass )                                          \
+   public:                                                                      \
+   static   ClassDef       ClassInfo;                                           \
+   static   void           *_newInstance();                                     \
+   virtual  const ClassDef *classinfo() const override;                         \
+   static   ResponseDef    Responses[];                                         \
+   void *operator new (size_t s) { return AllocClassObject(s, &ClassInfo); }    \
+   void  operator delete (void *ptr) { FreeClassObject(ptr, &ClassInfo); }
 
 class Class
 {
@@ -132,8 +190,6 @@ private:
 
 public:
    CLASS_PROTOTYPE_BASE(Class);
-   void *operator    new (size_t);
-   void  operator    delete (void *);
 
    virtual           ~Class();
    virtual void      Archive(Archiver &arc);
@@ -165,7 +221,8 @@ void              listInheritanceOrder(const char *classname);
 qboolean          checkInheritance(const ClassDef *superclass, const ClassDef *subclass);
 qboolean          checkInheritance(const ClassDef *superclass, const char *subclass);
 qboolean          checkInheritance(const char *superclass, const char *subclass);
-void              DisplayMemoryUsage();
+void              DisplayMemoryUsage(qboolean listclasses = false);
+void              ReleaseClassSlabs();
 
 inline qboolean Class::inheritsFrom(const ClassDef *c) const
 {
@@ -237,7 +237,7 @@ void Crawler::Pain(Event *ev)
    float oldhealth = (health + damage) / max_health;
    float newhealth = health / max_health;
 
-   SetVariable("other", ev->GetEntity(2));
+   SetVariable(otherVar, ev->GetEntity(2));
 
    // If we pass more than one range,  
    if((oldhealth > 0.75) && (newhealth <= 0.75))
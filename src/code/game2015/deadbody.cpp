@@ -63,7 +63,7 @@ void CopyToBodyQueue(edict_t *ent)
    body->solid                = ent->solid;
    body->clipmask             = ent->clipmask;
    body->owner                = ent->owner;
-   body->entity->movetype     = ent->entity->movetype;
+   body->entity->setMoveType(ent->entity->movetype);
    body->entity->takedamage   = DAMAGE_YES;
    body->entity->deadflag     = DEAD_DEAD;
    body->s.renderfx           &= ~RF_DONTDRAW;
@@ -45,6 +45,11 @@
 
 CLASS_DECLARATION(Listener, Entity, NULL);
 
+// Each entity gets its own spawn id so that an EntityHandle can tell whether
+// its edict has been reused.  Not archived, since every entity is spawned 
+// again when a game is loaded.
+static int entitySpawnCount = 0;
+
 // Player events
 Event EV_ClientConnect("client_connect");
 Event EV_ClientDisconnect("client_disconnect");
@@ -322,7 +327,7 @@ Entity::Entity() : Listener()
       edict = &g_edicts[game.spawn_entnum];
       LL_Remove(edict, next, prev);
       G_InitEdict(edict);
-      LL_Add(&active_edicts, edict, next, prev);
+      G_ActivateEdict(edict);
    }
    else
    {
@@ -332,6 +337,7 @@ Entity::Entity() : Listener()
    client = edict->client;
    edict->entity = this;
    entnum = edict->s.number;
+   spawnid = ++entitySpawnCount;
 
    m = G_GetSpawnArg("classname");
    if(m)
@@ -572,7 +578,7 @@ EXPORT_FROM_DLL void Entity::SetEntNum(int num)
    edict = &g_edicts[num];
    LL_Remove(edict, next, prev);
    G_InitEdict(edict);
-   LL_Add(&active_edicts, edict, next, prev);
+   G_ActivateEdict(edict);
 
    client = edict->client;
    edict->entity = this;
@@ -677,6 +683,9 @@ EXPORT_FROM_DLL void Entity::setModel(const char *mdl)
 
    gi.setmodel(edict, model.c_str());
 
+   // setmodel links brush models itself without going through gi.linkentity
+   G_ClearTraceCache();
+
    if(gi.IsModel(edict->s.modelindex))
    {
       Event *ev;
@@ -946,6 +955,7 @@ EXPORT_FROM_DLL void Entity::link(void)
    absmax = edict->absmax;
    centroid = (absmin + absmax) * 0.5;
    centroid.copyTo(edict->centroid);
+   G_RadiusLink(this);
 
    // If this has a parent, then set the areanum the same
    // as the parent's
@@ -1457,6 +1467,7 @@ void Entity::StartAnimating(void)
    // start animating
    AnimateFrame();
    animating = true;
+   Wake();
 }
 
 void Entity::NextAnim(int animnum)
@@ -260,6 +260,7 @@ public:
 
    // spawning variables
    int               entnum;
+   int               spawnid;       // unique to each entity spawned, used by EntityHandle
    edict_t          *edict;
    gclient_t        *client;
    const char       *classname;
@@ -396,6 +397,7 @@ public:
 
    void              setMoveType(int type);
    int               getMoveType() const;
+   void              Wake();
 
    void              setSolidType(solid_t type);
    int               getSolidType() const;
@@ -723,6 +725,17 @@ inline EXPORT_FROM_DLL float Entity::alpha() const
 inline EXPORT_FROM_DLL void Entity::setMoveType(int type)
 {
    movetype = type;
+   Wake();
+}
+
+// Makes sure G_RunFrame runs the entity.  Needs to be called whenever
+// something changes that G_RunEntity looks at.
+inline EXPORT_FROM_DLL void Entity::Wake()
+{
+   if(!edict->nextawake)
+   {
+      G_WakeEdict(edict);
+   }
 }
 
 inline EXPORT_FROM_DLL int Entity::getMoveType() const
@@ -968,6 +981,7 @@ inline EXPORT_FROM_DLL void Entity::Unarchive(Archiver &arc)
    arc.ReadVector(&absmax);
    arc.ReadVector(&size);
    arc.ReadVector(&centroid);
+   G_RadiusLink(this);
    arc.ReadVector(&origin);
    arc.ReadVector(&velocity);
    arc.ReadVector(&avelocity);
@@ -1053,6 +1067,108 @@ inline EXPORT_FROM_DLL void Entity::Unarchive(Archiver &arc)
    //###
 }
 
+/***********************************************************************
+
+  EntityHandle
+
+  Refers to an entity by entity number and spawn id.  Unlike EntityPtr, 
+  setting or clearing a handle doesn't write anything to the entity, and 
+  the entity doesn't have to go through its handles when it's removed.
+  A handle just stops resolving once its edict holds something else.
+
+***********************************************************************/
+
+class EntityHandle
+{
+private:
+   int entnum  = 0;
+   int spawnid = 0;
+
+public:
+   EntityHandle(Entity *ent = nullptr) noexcept
+   {
+      *this = ent;
+   }
+
+   EntityHandle &operator = (Entity *ent) noexcept
+   {
+      if(ent)
+      {
+         entnum  = ent->entnum;
+         spawnid = ent->spawnid;
+      }
+      else
+      {
+         entnum  = 0;
+         spawnid = 0;
+      }
+      return *this;
+   }
+
+   Entity *Get() const noexcept
+   {
+      Entity *ent;
+
+      if(!spawnid)
+      {
+         return nullptr;
+      }
+
+      ent = g_edicts[entnum].entity;
+      if(ent && (ent->spawnid == spawnid))
+      {
+         return ent;
+      }
+
+      return nullptr;
+   }
+
+   operator Entity *() const noexcept
+   {
+      return Get();
+   }
+
+   Entity *operator -> () const noexcept
+   {
+      return Get();
+   }
+
+   Entity &operator * () const noexcept
+   {
+      return *Get();
+   }
+
+   friend int operator == (const EntityHandle &a, const EntityHandle &b) noexcept
+   {
+      return a.Get() == b.Get();
+   }
+
+   friend int operator != (const EntityHandle &a, const EntityHandle &b) noexcept
+   {
+      return a.Get() != b.Get();
+   }
+
+   friend int operator == (const EntityHandle &a, Entity *b) noexcept
+   {
+      return a.Get() == b;
+   }
+
+   friend int operator != (const EntityHandle &a, Entity *b) noexcept
+   {
+      return a.Get() != b;
+   }
+
+   friend int operator == (Entity *a, const EntityHandle &b) noexcept
+   {
+      return a == b.Get();
+   }
+
+   friend int operator != (Entity *a, const EntityHandle &b) noexcept
+   {
+      return a != b.Get();
+   }
+};
+
 #include "worldspawn.h"
 
 // EOF
@@ -89,6 +89,7 @@ EonAndPeon::EonAndPeon() : Peon()
 
    setModel("boss_peon.def");
    flags |= FL_POSTTHINK;
+   Wake();
 }
 
 void EonAndPeon::Chatter(const char *snd, float chance, float volume, int channel)
@@ -178,6 +178,12 @@ struct edict_s
 
    edict_t        *next;
    edict_t        *prev;
+
+   // awake edicts, kept in the same order as active_edicts.  Both are
+   // NULL when the edict is asleep.
+   edict_t        *nextawake;
+   edict_t        *prevawake;
+   unsigned        runorder;
 };
 
 //### data structure of client ghost data
@@ -14,7 +14,7 @@
 // 
 
 //### upped savegame version for the add-on pack
-#define SAVEGAME_VERSION 16
+#define SAVEGAME_VERSION 17
 
 #include <setjmp.h>
 #include "limits.h"
@@ -46,6 +46,7 @@ game_export_t		globals;
 edict_t				*g_edicts = NULL;
 edict_t				active_edicts;
 edict_t				free_edicts;
+edict_t				awake_edicts;
 
 netconsole_t      *g_consoles;
 netconbuffer_t    *g_conbuffers;
@@ -78,6 +79,14 @@ cvar_t   *dialog;
 cvar_t	*precache;
 cvar_t   *g_showmem;
 cvar_t   *g_timeents;
+cvar_t   *g_scriptcache;
+cvar_t   *g_profilescripts;
+cvar_t   *g_scriptbudget;
+cvar_t   *g_scriptframetime;
+cvar_t   *g_timescripts;
+cvar_t   *g_sleepents;
+cvar_t   *g_checksleep;
+cvar_t   *g_profileframes;
 
 cvar_t	*sv_maxvelocity;
 cvar_t	*sv_gravity;
@@ -115,6 +124,7 @@ cvar_t   *sv_showdamage;
 cvar_t   *sv_showdamagelocation;
 cvar_t	*sv_traceinfo;
 cvar_t	*sv_drawtrace;
+cvar_t	*sv_tracecache;
 cvar_t   *sv_maplist;
 cvar_t   *sv_footsteps;
 cvar_t   *sv_fatrockets;
@@ -142,6 +152,7 @@ float     reset_timeofs;
 //###
 
 int		sv_numtraces;
+int		sv_numcachedtraces;
 
 usercmd_t *current_ucmd;
 
@@ -302,6 +313,14 @@ void G_InitGame(void)
    g_unlimited_ammo	= gi.cvar("g_unlimited_ammo", "0", CVAR_SERVERINFO);
    g_showmem         = gi.cvar("g_showmem", "0", 0);
    g_timeents        = gi.cvar("g_timeents", "0", 0);
+   g_scriptcache     = gi.cvar("g_scriptcache", "1", 0);
+   g_profilescripts  = gi.cvar("g_profilescripts", "0", 0);
+   g_scriptbudget    = gi.cvar("g_scriptbudget", "0", 0);
+   g_scriptframetime = gi.cvar("g_scriptframetime", "0", 0);
+   g_timescripts     = gi.cvar("g_timescripts", "0", 0);
+   g_sleepents       = gi.cvar("g_sleepents", "1", 0);
+   g_checksleep      = gi.cvar("g_checksleep", "0", 0);
+   g_profileframes   = gi.cvar("g_profileframes", "0", 0);
    dm_respawn			= gi.cvar("dm_respawn", "2", CVAR_SERVERINFO);
    nomonsters			= gi.cvar("nomonsters", "0", CVAR_SERVERINFO);
    dialog   			= gi.cvar("dialog", "3", CVAR_SERVERINFO | CVAR_ARCHIVE); //### changed default
@@ -324,6 +343,7 @@ void G_InitGame(void)
 
    sv_traceinfo		= gi.cvar("sv_traceinfo", "0", 0);
    sv_drawtrace		= gi.cvar("sv_drawtrace", "0", 0);
+   sv_tracecache		= gi.cvar("sv_tracecache", "0", 0);
 
    // debug stuff
    sv_showbboxes		= gi.cvar("sv_showbboxes", "0", 0);
@@ -363,6 +383,7 @@ void G_InitGame(void)
 
    G_InitEvents();
    sv_numtraces = 0;
+   sv_numcachedtraces = 0;
 
    game.maxentities = maxentities->value;
    if(maxclients->value * 8 > game.maxentities)
@@ -390,6 +411,8 @@ void G_AllocGameData(void)
    // Initialize debug lines
    G_AllocDebugLines();
 
+   G_AllocRadiusGrid();
+
    // initialize all entities for this game
    g_edicts =  (edict_t *)gi.TagMalloc(game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
    globals.edicts = g_edicts;
@@ -398,6 +421,7 @@ void G_AllocGameData(void)
    // Add all the edicts to the free list
    LL_Reset(&free_edicts, next, prev);
    LL_Reset(&active_edicts, next, prev);
+   G_ResetAwakeEdicts();
    for(i = 0; i < game.maxentities; i++)
    {
       LL_Add(&free_edicts, &g_edicts[i], next, prev);
@@ -785,6 +809,9 @@ void ReadLevel(const char *filename)
 
    arc.Close();
 
+   // now that the object pointers are fixed up, let them know about their events
+   G_LinkUnarchivedEvents();
+
    // call the precache scripts
    G_Precache();
 
@@ -813,6 +840,7 @@ and global variables
 game_export_t *GetGameAPI(game_import_t *import)
 {
    gi = *import;
+   G_InitTraceCache();
 
    globals.apiversion				= GAME_API_VERSION;
    globals.Init						= G_InitGame;
@@ -1356,6 +1384,676 @@ void G_DrawCSystem(void)
    G_DebugLine(pos, pos + u * 48, 0, 0, 1.0, 1);
 }
 
+/*
+===============================================================================
+
+Frame profiler
+
+When g_profileframes is set, each phase of G_RunFrame is timed.  The phases
+inside G_RunEntity (animation, prethink, physics by movetype, and
+postthink) are added up over all the entities run that frame.  The last
+FRAMEPROF_WINDOW frames are kept for the percentiles, along with the
+slowest frames since the last reset.  Entity time is also totaled by class,
+and traces are counted by the reason passed to G_Trace.
+
+  sv frameprof [phases]
+  sv frameprof slow [count]
+  sv frameprof classes [count]
+  sv frameprof traces [count]
+  sv frameprof reset
+
+===============================================================================
+*/
+
+#define FRAMEPROF_WINDOW      1024  // frames the percentiles are taken over
+#define FRAMEPROF_SLOWEST     32    // slowest frames kept since the last reset
+#define TRACEPROF_HASHSIZE    256
+
+static const char *framePhaseNames[NUM_FRAMEPHASES] =
+{
+   "events",
+   "animate",
+   "prethink",
+   "pusher",
+   "noclip",
+   "step",
+   "toss",
+   "rope",
+   "hoverbike",
+   "ceilingstep",
+   "postthink",
+   "postevents",
+   "dmrules",
+   "clientframes",
+   "frame"
+};
+
+typedef struct
+{
+   int         framenum;
+   float       time;
+   unsigned    phase[NUM_FRAMEPHASES];   // microseconds
+   unsigned    scripts;                  // microseconds, already counted in the event phases
+   int         traces;
+   int         entities;
+   const char *slowclass;
+   int         slowentnum;
+   unsigned    slowtime;
+} frameprofile_t;
+
+typedef struct
+{
+   int      count;
+   double   total;   // microseconds
+   unsigned max;     // microseconds
+} classframeprofile_t;
+
+typedef struct traceprofile_s
+{
+   char                   *reason;
+   int                     count;
+   struct traceprofile_s  *next;
+} traceprofile_t;
+
+qboolean                    frameProfiling = false;
+
+static unsigned             frameProfileStart;
+static frameprofile_t       currentFrameProfile;
+static frameprofile_t      *frameWindow = nullptr;
+static int                  numFrameWindow = 0;
+static int                  frameWindowPos = 0;
+static frameprofile_t       slowFrames[FRAMEPROF_SLOWEST];
+static int                  numSlowFrames = 0;
+static int                  profiledFrames = 0;
+
+static classframeprofile_t *classFrameProfile = nullptr;   // by ClassDef::treePre
+static int                  numClassFrameProfile = 0;
+
+static traceprofile_t      *traceProfileHash[TRACEPROF_HASHSIZE];
+static int                  numTraceProfile = 0;
+
+void G_BeginFrameProfile(void)
+{
+   frameProfiling = (g_profileframes->value != 0);
+   if(!frameProfiling)
+   {
+      return;
+   }
+
+   memset(&currentFrameProfile, 0, sizeof(currentFrameProfile));
+   currentFrameProfile.framenum = level.framenum;
+   currentFrameProfile.time = level.time;
+   frameProfileStart = G_Microseconds();
+}
+
+unsigned G_FrameProfilePhase(int phase, unsigned start)
+{
+   unsigned now;
+
+   now = G_Microseconds();
+   currentFrameProfile.phase[phase] += now - start;
+
+   return now;
+}
+
+unsigned G_FrameProfilePhysics(int movetype, unsigned start)
+{
+   switch(movetype)
+   {
+   case MOVETYPE_PUSH:
+   case MOVETYPE_STOP:
+      return G_FrameProfilePhase(FP_PUSHER, start);
+   case MOVETYPE_NOCLIP:
+      return G_FrameProfilePhase(FP_NOCLIP, start);
+   case MOVETYPE_STEP:
+   case MOVETYPE_HURL:
+      return G_FrameProfilePhase(FP_STEP, start);
+   case MOVETYPE_TOSS:
+   case MOVETYPE_BOUNCE:
+   case MOVETYPE_FLY:
+   case MOVETYPE_FLYMISSILE:
+   case MOVETYPE_SLIDE:
+   case MOVETYPE_VEHICLE:
+      return G_FrameProfilePhase(FP_TOSS, start);
+   case MOVETYPE_ROPE:
+      return G_FrameProfilePhase(FP_ROPE, start);
+   case MOVETYPE_HOVERBIKE:
+      return G_FrameProfilePhase(FP_HOVERBIKE, start);
+   case MOVETYPE_CEILINGSTEP:
+      return G_FrameProfilePhase(FP_CEILINGSTEP, start);
+   default:
+      // no physics
+      return start;
+   }
+}
+
+void G_FrameProfileEntity(const ClassDef *cls, int entnum, unsigned elapsed)
+{
+   const ClassDef      *list;
+   const ClassDef      *c;
+   classframeprofile_t *p;
+
+   if(!classFrameProfile)
+   {
+      list = getClassList();
+      for(c = list->next; c != list; c = c->next)
+      {
+         if(c->treePre >= numClassFrameProfile)
+         {
+            numClassFrameProfile = c->treePre + 1;
+         }
+      }
+
+      classFrameProfile = new classframeprofile_t[numClassFrameProfile];
+      memset(classFrameProfile, 0, sizeof(classframeprofile_t) * numClassFrameProfile);
+   }
+
+   if(cls->treePre < numClassFrameProfile)
+   {
+      p = &classFrameProfile[cls->treePre];
+      p->count++;
+      p->total += elapsed;
+      if(elapsed > p->max)
+      {
+         p->max = elapsed;
+      }
+   }
+
+   currentFrameProfile.entities++;
+   if(elapsed >= currentFrameProfile.slowtime)
+   {
+      currentFrameProfile.slowclass = cls->classname;
+      currentFrameProfile.slowentnum = entnum;
+      currentFrameProfile.slowtime = elapsed;
+   }
+}
+
+void G_FrameProfileTrace(const char *reason)
+{
+   traceprofile_t *t;
+   unsigned        hash;
+   const char     *s;
+
+   if(!reason)
+   {
+      reason = "";
+   }
+
+   hash = 0;
+   for(s = reason; *s; s++)
+   {
+      hash = hash * 31 + (unsigned char)*s;
+   }
+   hash &= TRACEPROF_HASHSIZE - 1;
+
+   for(t = traceProfileHash[hash]; t; t = t->next)
+   {
+      if(!strcmp(t->reason, reason))
+      {
+         t->count++;
+         return;
+      }
+   }
+
+   // reasons aren't always literals, so keep a copy
+   t = new traceprofile_t;
+   t->reason = new char[strlen(reason) + 1];
+   strcpy(t->reason, reason);
+   t->count = 1;
+   t->next = traceProfileHash[hash];
+   traceProfileHash[hash] = t;
+   numTraceProfile++;
+}
+
+void G_EndFrameProfile(void)
+{
+   frameprofile_t *f;
+   int             i;
+   int             fastest;
+
+   if(!frameProfiling)
+   {
+      return;
+   }
+
+   f = &currentFrameProfile;
+   f->phase[FP_FRAME] = G_Microseconds() - frameProfileStart;
+   f->scripts = Director.FrameScriptTime();
+   f->traces = sv_numtraces;
+
+   if(!frameWindow)
+   {
+      frameWindow = new frameprofile_t[FRAMEPROF_WINDOW];
+   }
+
+   frameWindow[frameWindowPos] = *f;
+   frameWindowPos = (frameWindowPos + 1) % FRAMEPROF_WINDOW;
+   if(numFrameWindow < FRAMEPROF_WINDOW)
+   {
+      numFrameWindow++;
+   }
+
+   // keep the slowest frames, replacing the fastest of them once it's full
+   if(numSlowFrames < FRAMEPROF_SLOWEST)
+   {
+      slowFrames[numSlowFrames++] = *f;
+   }
+   else
+   {
+      fastest = 0;
+      for(i = 1; i < numSlowFrames; i++)
+      {
+         if(slowFrames[i].phase[FP_FRAME] < slowFrames[fastest].phase[FP_FRAME])
+         {
+            fastest = i;
+         }
+      }
+
+      if(f->phase[FP_FRAME] > slowFrames[fastest].phase[FP_FRAME])
+      {
+         slowFrames[fastest] = *f;
+      }
+   }
+
+   profiledFrames++;
+}
+
+static void ResetFrameProfile(void)
+{
+   traceprofile_t *t;
+   traceprofile_t *next;
+   int             i;
+
+   if(frameWindow)
+   {
+      delete [] frameWindow;
+      frameWindow = nullptr;
+   }
+   numFrameWindow = 0;
+   frameWindowPos = 0;
+   numSlowFrames = 0;
+   profiledFrames = 0;
+
+   if(classFrameProfile)
+   {
+      delete [] classFrameProfile;
+      classFrameProfile = nullptr;
+   }
+   numClassFrameProfile = 0;
+
+   for(i = 0; i < TRACEPROF_HASHSIZE; i++)
+   {
+      for(t = traceProfileHash[i]; t; t = next)
+      {
+         next = t->next;
+         delete [] t->reason;
+         delete t;
+      }
+      traceProfileHash[i] = nullptr;
+   }
+   numTraceProfile = 0;
+}
+
+static int compareUnsigned(const void *arg1, const void *arg2)
+{
+   unsigned u1 = *(const unsigned *)arg1;
+   unsigned u2 = *(const unsigned *)arg2;
+
+   if(u1 == u2)
+   {
+      return 0;
+   }
+
+   return (u1 < u2) ? -1 : 1;
+}
+
+static void PrintFramePhases(void)
+{
+   unsigned *values;
+   double    total;
+   int       phase;
+   int       i;
+
+   values = new unsigned[numFrameWindow];
+
+   gi.printf("%-14s %8s %8s %8s %8s %8s\n", "phase", "avg us", "p50 us", "p95 us", "p99 us", "max us");
+   gi.printf("-------------- -------- -------- -------- -------- --------\n");
+   for(phase = 0; phase < NUM_FRAMEPHASES; phase++)
+   {
+      total = 0;
+      for(i = 0; i < numFrameWindow; i++)
+      {
+         values[i] = frameWindow[i].phase[phase];
+         total += values[i];
+      }
+
+      qsort(values, numFrameWindow, sizeof(unsigned), compareUnsigned);
+
+      gi.printf("%-14s %8.0f %8u %8u %8u %8u\n", framePhaseNames[phase], total / numFrameWindow,
+                values[numFrameWindow * 50 / 100], values[numFrameWindow * 95 / 100],
+                values[numFrameWindow * 99 / 100], values[numFrameWindow - 1]);
+   }
+
+   delete [] values;
+
+   gi.printf("\nlast %d of %d frames profiled\n", numFrameWindow, profiledFrames);
+}
+
+static int compareSlowFrames(const void *arg1, const void *arg2)
+{
+   const frameprofile_t *f1 = (const frameprofile_t *)arg1;
+   const frameprofile_t *f2 = (const frameprofile_t *)arg2;
+
+   return compareUnsigned(&f2->phase[FP_FRAME], &f1->phase[FP_FRAME]);
+}
+
+static void PrintSlowFrames(int count)
+{
+   frameprofile_t *f;
+   int             phase;
+   int             i;
+
+   qsort(slowFrames, numSlowFrames, sizeof(frameprofile_t), compareSlowFrames);
+   if(count > numSlowFrames)
+   {
+      count = numSlowFrames;
+   }
+
+   for(i = 0; i < count; i++)
+   {
+      f = &slowFrames[i];
+      gi.printf("frame %d (%.1f) : %u us, %d entities, %d traces, scripts %u us\n", f->framenum, f->time,
+                f->phase[FP_FRAME], f->entities, f->traces, f->scripts);
+      if(f->slowclass)
+      {
+         gi.printf("   slowest entity '%s'(%d) : %u us\n", f->slowclass, f->slowentnum, f->slowtime);
+      }
+
+      gi.printf("  ");
+      for(phase = 0; phase < FP_FRAME; phase++)
+      {
+         if(f->phase[phase])
+         {
+            gi.printf(" %s %u", framePhaseNames[phase], f->phase[phase]);
+         }
+      }
+      gi.printf("\n");
+   }
+}
+
+typedef struct
+{
+   const char                *name;
+   const classframeprofile_t *profile;
+} classframeentry_t;
+
+static int compareClassFrameEntries(const void *arg1, const void *arg2)
+{
+   const classframeprofile_t *p1 = ((const classframeentry_t *)arg1)->profile;
+   const classframeprofile_t *p2 = ((const classframeentry_t *)arg2)->profile;
+
+   // most time first
+   if(p1->total != p2->total)
+   {
+      return (p1->total < p2->total) ? 1 : -1;
+   }
+
+   return p2->count - p1->count;
+}
+
+static void PrintClassFrameProfile(int count)
+{
+   const ClassDef            *list;
+   const ClassDef            *c;
+   const classframeprofile_t *p;
+   classframeentry_t         *entries;
+   int                        num;
+   int                        i;
+
+   if(!classFrameProfile)
+   {
+      return;
+   }
+
+   num = 0;
+   entries = new classframeentry_t[numClassFrameProfile + 1];
+   list = getClassList();
+   for(c = list->next; c != list; c = c->next)
+   {
+      if((c->treePre < numClassFrameProfile) && classFrameProfile[c->treePre].count)
+      {
+         entries[num].name = c->classname;
+         entries[num].profile = &classFrameProfile[c->treePre];
+         num++;
+      }
+   }
+
+   qsort(entries, num, sizeof(classframeentry_t), compareClassFrameEntries);
+   if(count > num)
+   {
+      count = num;
+   }
+
+   gi.printf("%-32s %8s %10s %8s %8s\n", "class", "runs", "total ms", "avg us", "max us");
+   gi.printf("-------------------------------- -------- ---------- -------- --------\n");
+   for(i = 0; i < count; i++)
+   {
+      p = entries[i].profile;
+      gi.printf("%-32s %8d %10.2f %8.1f %8u\n", entries[i].name, p->count, p->total / 1000.0,
+                p->total / p->count, p->max);
+   }
+
+   delete [] entries;
+}
+
+static int compareTraceProfiles(const void *arg1, const void *arg2)
+{
+   const traceprofile_t *t1 = *(const traceprofile_t **)arg1;
+   const traceprofile_t *t2 = *(const traceprofile_t **)arg2;
+
+   return t2->count - t1->count;
+}
+
+static void PrintTraceProfile(int count)
+{
+   traceprofile_t **entries;
+   traceprofile_t  *t;
+   int              num;
+   int              i;
+
+   num = 0;
+   entries = new traceprofile_t *[numTraceProfile + 1];
+   for(i = 0; i < TRACEPROF_HASHSIZE; i++)
+   {
+      for(t = traceProfileHash[i]; t; t = t->next)
+      {
+         entries[num++] = t;
+      }
+   }
+
+   qsort(entries, num, sizeof(traceprofile_t *), compareTraceProfiles);
+   if(count > num)
+   {
+      count = num;
+   }
+
+   gi.printf("%-40s %8s %10s\n", "reason", "traces", "per frame");
+   gi.printf("---------------------------------------- -------- ----------\n");
+   for(i = 0; i < count; i++)
+   {
+      gi.printf("%-40s %8d %10.2f\n", entries[i]->reason, entries[i]->count,
+                profiledFrames ? (float)entries[i]->count / profiledFrames : 0.0f);
+   }
+
+   delete [] entries;
+}
+
+void G_FrameProfileCommand(void)
+{
+   const char *cmd;
+   int         count;
+
+   cmd = gi.argv(2);
+   if(!Q_stricmp(cmd, "reset"))
+   {
+      ResetFrameProfile();
+      return;
+   }
+
+   if(!numFrameWindow)
+   {
+      gi.printf("No frames profiled.  Set g_profileframes to 1 to start.\n");
+      return;
+   }
+
+   count = 20;
+   if(gi.argc() > 3)
+   {
+      count = atoi(gi.argv(3));
+   }
+
+   if(!Q_stricmp(cmd, "slow"))
+   {
+      PrintSlowFrames(count);
+   }
+   else if(!Q_stricmp(cmd, "classes"))
+   {
+      PrintClassFrameProfile(count);
+   }
+   else if(!Q_stricmp(cmd, "traces"))
+   {
+      PrintTraceProfile(count);
+   }
+   else if(!*cmd || !Q_stricmp(cmd, "phases"))
+   {
+      PrintFramePhases();
+   }
+   else
+   {
+      gi.printf("Usage: sv frameprof [phases | slow [count] | classes [count] | traces [count] | reset]\n");
+   }
+}
+
+/*
+================
+Awake edicts
+
+G_RunFrame only runs the edicts that are awake.  An entity that has no
+physics, isn't animating, and doesn't prethink or postthink has nothing to
+do in G_RunEntity, so it's put to sleep after it's run and woken up again
+by whatever changes that (see Entity::Wake).  Awake edicts are kept in the
+same order as active_edicts so that entities still run in the order they
+were spawned.
+
+g_checksleep looks through the sleeping entities every frame and wakes
+any that were missed.
+================
+*/
+
+static unsigned edictRunOrder   = 0;       // runorder of the last edict added to active_edicts
+static unsigned currentRunOrder = 0;       // runorder of the edict G_RunFrame is on
+static qboolean edictsAsleep    = false;
+
+void G_ResetAwakeEdicts(void)
+{
+   LL_Reset(&awake_edicts, nextawake, prevawake);
+   edictRunOrder   = 0;
+   currentRunOrder = 0;
+   edictsAsleep    = false;
+}
+
+void G_ActivateEdict(edict_t *e)
+{
+   LL_Add(&active_edicts, e, next, prev);
+
+   G_SleepEdict(e);
+   e->runorder = ++edictRunOrder;
+   G_WakeEdict(e);
+}
+
+void G_WakeEdict(edict_t *e)
+{
+   edict_t *after;
+
+   if(e->nextawake || !e->inuse)
+   {
+      return;
+   }
+
+   // usually this is a new edict, which goes on the end
+   for(after = awake_edicts.prevawake; after != &awake_edicts; after = after->prevawake)
+   {
+      if(after->runorder < e->runorder)
+      {
+         break;
+      }
+   }
+
+   LL_AddFirst(after, e, nextawake, prevawake);
+
+   // if G_RunFrame hasn't gotten to it yet, make sure it gets run this frame
+   if(level.next_edict && (level.next_edict == e->nextawake) && (e->runorder > currentRunOrder))
+   {
+      level.next_edict = e;
+   }
+}
+
+void G_SleepEdict(edict_t *e)
+{
+   if(!e->nextawake)
+   {
+      return;
+   }
+
+   if(level.next_edict == e)
+   {
+      level.next_edict = e->nextawake;
+   }
+
+   LL_Remove(e, nextawake, prevawake);
+   e->nextawake = NULL;
+   e->prevawake = NULL;
+}
+
+static qboolean G_EdictIdle(edict_t *e)
+{
+   Entity *ent;
+
+   ent = e->entity;
+   if(!ent || ent->animating || (ent->flags & (FL_PRETHINK | FL_POSTTHINK)))
+   {
+      return false;
+   }
+
+   return (ent->movetype == MOVETYPE_NONE) || (ent->movetype == MOVETYPE_WALK);
+}
+
+static void G_WakeSleepingEdicts(qboolean all)
+{
+   edict_t *e;
+
+   for(e = active_edicts.next; e != &active_edicts; e = e->next)
+   {
+      if(e->nextawake || (!all && G_EdictIdle(e)))
+      {
+         continue;
+      }
+
+      if(!all)
+      {
+         gi.dprintf("G_RunFrame: '%s'(%d) was asleep but needs to run\n",
+            e->entity ? e->entity->getClassname() : e->entname, (int)(e - g_edicts));
+      }
+
+      G_WakeEdict(e);
+   }
+
+   if(all)
+   {
+      edictsAsleep = false;
+   }
+}
+
 /*
 ================
 G_RunFrame
@@ -1369,8 +2067,13 @@ void G_RunFrame(void)
    Entity	*ent;
    int		num;
    qboolean showentnums;
+   qboolean sleep;
    int      start;
    int      end;
+   unsigned phasestart;
+   unsigned entstart;
+   const ClassDef *entclass;
+   int      entnum;
 
    // If we get an error, call the server's error function
    if(setjmp(G_AbortGame))
@@ -1404,6 +2107,12 @@ void G_RunFrame(void)
 
    path_checksthisframe = 0;
 
+   Director.BeginFrame();
+   G_BeginFrameProfile();
+
+   // nothing from the last frame can be trusted
+   G_ClearTraceCache();
+
    // Reset debug lines
    G_InitDebugLines();
 
@@ -1420,18 +2129,35 @@ void G_RunFrame(void)
 
    // Process most of the events before the physics are run
    // so that we can affect the physics immediately
+   phasestart = frameProfiling ? G_Microseconds() : 0;
    G_ProcessPendingEvents();
+   if(frameProfiling)
+   {
+      G_FrameProfilePhase(FP_EVENTS, phasestart);
+   }
+
+   // entity numbers are drawn from G_RunFrame, so everything has to run
+   sleep = (g_sleepents->value && !showentnums);
+   if(!sleep && edictsAsleep)
+   {
+      G_WakeSleepingEdicts(true);
+   }
+   else if(g_checksleep->value)
+   {
+      G_WakeSleepingEdicts(false);
+   }
 
    //
    // treat each object in turn
    //
-   for(edict = active_edicts.next, num = 0; edict != &active_edicts; edict = level.next_edict, num++)
+   for(edict = awake_edicts.nextawake, num = 0; edict != &awake_edicts; edict = level.next_edict, num++)
    {
       assert(edict);
       assert(edict->inuse);
       assert(edict->entity);
 
-      level.next_edict = edict->next;
+      level.next_edict = edict->nextawake;
+      currentRunOrder = edict->runorder;
 
       // Paranoia - It's a way of life
       assert(num <= MAX_EDICTS);
@@ -1444,6 +2170,14 @@ void G_RunFrame(void)
       ent = edict->entity;
       level.current_entity = ent;
 
+      if(frameProfiling)
+      {
+         // the entity may be gone once it's been run
+         entclass = ent->classinfo();
+         entnum = ent->entnum;
+         entstart = G_Microseconds();
+      }
+
       if(g_timeents->value)
       {
          start = G_Milliseconds();
@@ -1460,20 +2194,52 @@ void G_RunFrame(void)
          G_RunEntity(ent);
       }
 
+      if(frameProfiling)
+      {
+         G_FrameProfileEntity(entclass, entnum, G_Microseconds() - entstart);
+      }
+
       if(showentnums)
       {
          G_DrawDebugNumber(ent->worldorigin + Vector(0, 0, ent->maxs.z + 2), ent->entnum, 2, 1, 1, 0);
       }
+
+      if(sleep && edict->inuse && G_EdictIdle(edict))
+      {
+         G_SleepEdict(edict);
+         edictsAsleep = true;
+      }
    }
 
+   level.next_edict = NULL;
+
    // Process any pending events that got posted during the physics code.
+   phasestart = frameProfiling ? G_Microseconds() : 0;
    G_ProcessPendingEvents();
+   if(frameProfiling)
+   {
+      phasestart = G_FrameProfilePhase(FP_POSTEVENTS, phasestart);
+   }
+
+   if(g_timescripts->value && (Director.FrameScriptTime() >= g_timescripts->value * 1000))
+   {
+      G_DebugPrintf("%d: scripts : %.2f ms, %d instructions, %d threads suspended\n", level.framenum,
+         Director.FrameScriptTime() / 1000.0f, Director.FrameInstructions(), Director.FrameYields());
+   }
 
    // see if it is time to end a deathmatch
    G_CheckDMRules();
+   if(frameProfiling)
+   {
+      phasestart = G_FrameProfilePhase(FP_DMRULES, phasestart);
+   }
 
    // build the playerstate_t structures for all players
    G_ClientEndServerFrames();
+   if(frameProfiling)
+   {
+      G_FrameProfilePhase(FP_CLIENTFRAMES, phasestart);
+   }
 
    // see if we should draw the bounding boxes
    G_ClientDrawBoundingBoxes();
@@ -1489,10 +2255,25 @@ void G_RunFrame(void)
       {
          gi.dprintf("%0.1f : Total traces %d\n", level.time, sv_numtraces);
       }
+
+      if(sv_tracecache->value && sv_numtraces)
+      {
+         if(sv_traceinfo->value == 3)
+         {
+            G_DebugPrintf("%0.1f : Cached traces %d (%d%%)\n", level.time, sv_numcachedtraces, sv_numcachedtraces * 100 / sv_numtraces);
+         }
+         else
+         {
+            gi.dprintf("%0.1f : Cached traces %d (%d%%)\n", level.time, sv_numcachedtraces, sv_numcachedtraces * 100 / sv_numtraces);
+         }
+      }
    }
 
+   G_EndFrameProfile();
+
    // reset out count of the number of game traces
    sv_numtraces = 0;
+   sv_numcachedtraces = 0;
 
 #ifdef SIN_ARCADE
    G_CheckFirstPlace();
@@ -3374,6 +4155,34 @@ void G_ServerCommand(void)
       SVCmd_Reset_f();
    }
    //###
+   else if(Q_stricmp(cmd, "eventpool") == 0)
+   {
+      G_PrintEventPoolStats();
+   }
+   else if(Q_stricmp(cmd, "classmem") == 0)
+   {
+      DisplayMemoryUsage(true);
+   }
+   else if(Q_stricmp(cmd, "eventprof") == 0)
+   {
+      G_EventProfileCommand();
+   }
+   else if(Q_stricmp(cmd, "scriptload") == 0)
+   {
+      ScriptLib.PrintLoadTimes();
+   }
+   else if(Q_stricmp(cmd, "scriptprof") == 0)
+   {
+      G_ScriptProfileCommand();
+   }
+   else if(Q_stricmp(cmd, "frameprof") == 0)
+   {
+      G_FrameProfileCommand();
+   }
+   else if(Q_stricmp(cmd, "tracebench") == 0)
+   {
+      G_TraceBenchCommand();
+   }
    else
    {
       gi.cprintf(NULL, PRINT_HIGH, "Unknown server command \"%s\"\n", cmd);
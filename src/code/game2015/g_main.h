@@ -33,6 +33,7 @@ extern   game_export_t  globals;
 extern   edict_t       *g_edicts;
 extern   edict_t        active_edicts;
 extern   edict_t        free_edicts;
+extern   edict_t        awake_edicts;
 
 extern   netconsole_t   *g_consoles;
 extern   netconbuffer_t *g_conbuffers;
@@ -61,6 +62,14 @@ extern   cvar_t   *g_select_empty;
 extern   cvar_t   *g_unlimited_ammo;
 extern   cvar_t   *nomonsters;
 extern   cvar_t   *dialog;
+extern   cvar_t   *g_scriptcache;
+extern   cvar_t   *g_profilescripts;
+extern   cvar_t   *g_scriptbudget;
+extern   cvar_t   *g_scriptframetime;
+extern   cvar_t   *g_timescripts;
+extern   cvar_t   *g_sleepents;
+extern   cvar_t   *g_checksleep;
+extern   cvar_t   *g_profileframes;
 
 extern   cvar_t   *sv_gravity;
 extern   cvar_t   *sv_maxvelocity;
@@ -95,7 +104,9 @@ extern   cvar_t   *sv_footsteps;
 
 extern   cvar_t   *sv_traceinfo;
 extern   cvar_t   *sv_drawtrace;
+extern   cvar_t   *sv_tracecache;
 extern   int       sv_numtraces;
+extern   int       sv_numcachedtraces;
 
 extern   cvar_t   *parentmode;
 extern   cvar_t   *dedicated;
@@ -124,6 +135,37 @@ void     G_DeathmatchScoreboardMessage(Entity *client, Entity *killer);
 void     G_WriteClient(Archiver &arc, gclient_t *client);
 void     G_AllocGameData(void);
 
+// Frame profiler phases, see G_RunFrame and G_RunEntity
+typedef enum
+{
+   FP_EVENTS,
+   FP_ANIMATE,
+   FP_PRETHINK,
+   FP_PUSHER,
+   FP_NOCLIP,
+   FP_STEP,
+   FP_TOSS,
+   FP_ROPE,
+   FP_HOVERBIKE,
+   FP_CEILINGSTEP,
+   FP_POSTTHINK,
+   FP_POSTEVENTS,
+   FP_DMRULES,
+   FP_CLIENTFRAMES,
+   FP_FRAME,
+   NUM_FRAMEPHASES
+} framephase_t;
+
+extern   qboolean frameProfiling;
+
+void     G_BeginFrameProfile(void);
+void     G_EndFrameProfile(void);
+unsigned G_FrameProfilePhase(int phase, unsigned start);
+unsigned G_FrameProfilePhysics(int movetype, unsigned start);
+void     G_FrameProfileEntity(const ClassDef *cls, int entnum, unsigned elapsed);
+void     G_FrameProfileTrace(const char *reason);
+void     G_FrameProfileCommand(void);
+
 extern "C" {
    void     G_ClientEndServerFrames(void);
    void     G_ClientThink(edict_t *ent, usercmd_t *cmd);
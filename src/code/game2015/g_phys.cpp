@@ -1814,22 +1814,34 @@ G_RunEntity
 void G_RunEntity(Entity *ent)
 {
    edict_t *edict;
+   unsigned start;
+   int      movetype;
 
    edict = ent->edict;
+   start = frameProfiling ? G_Microseconds() : 0;
 
    if(ent->animating && !level.intermissiontime)
    {
       ent->AnimateFrame();
+      if(frameProfiling)
+      {
+         start = G_FrameProfilePhase(FP_ANIMATE, start);
+      }
    }
 
    if(edict->inuse && ent->flags & FL_PRETHINK)
    {
       ent->Prethink();
+      if(frameProfiling)
+      {
+         start = G_FrameProfilePhase(FP_PRETHINK, start);
+      }
    }
 
    if(edict->inuse)
    {
-      switch((int)ent->movetype)
+      movetype = (int)ent->movetype;
+      switch(movetype)
       {
       case MOVETYPE_PUSH:
       case MOVETYPE_STOP:
@@ -1871,11 +1883,20 @@ void G_RunEntity(Entity *ent)
       default:
          gi.error("G_Physics: bad movetype %i", (int)ent->movetype);
       }
+
+      if(frameProfiling)
+      {
+         start = G_FrameProfilePhysics(movetype, start);
+      }
    }
 
    if((edict->inuse) && (ent->flags & FL_POSTTHINK))
    {
       ent->Postthink();
+      if(frameProfiling)
+      {
+         G_FrameProfilePhase(FP_POSTTHINK, start);
+      }
    }
 }
 
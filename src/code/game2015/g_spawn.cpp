@@ -917,6 +917,9 @@ void G_LevelShutdown(void)
    // clearout any waiting events
    G_ClearEventList();
 
+   // everything from the level is gone, so hand the empty slabs back
+   ReleaseClassSlabs();
+
    gi.FreeTags(TAG_LEVEL);
 }
 
@@ -930,10 +933,12 @@ void G_ResetEdicts(void)
    int i;
 
    memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
+   G_ClearRadiusGrid();
 
    // Add all the edicts to the free list
    LL_Reset(&free_edicts, next, prev);
    LL_Reset(&active_edicts, next, prev);
+   G_ResetAwakeEdicts();
    for(i = 0; i < game.maxentities; i++)
    {
       LL_Add(&free_edicts, &g_edicts[i], next, prev);
@@ -1136,6 +1141,7 @@ void G_SpawnEntities(const char *mapname, const char *entities, const char *spaw
 
    // reset out count of the number of game traces
    sv_numtraces = 0;
+   sv_numcachedtraces = 0;
 
    level.playerfrozen = false;
 
@@ -1261,7 +1267,7 @@ edict_t *G_Spawn(void)
          G_InitEdict(e);
          assert(active_edicts.next);
          assert(active_edicts.prev);
-         LL_Add(&active_edicts, e, next, prev);
+         G_ActivateEdict(e);
          assert(e->next);
          assert(e->prev);
          return e;
@@ -1280,7 +1286,7 @@ edict_t *G_Spawn(void)
    G_InitEdict(e);
    assert(active_edicts.next);
    assert(active_edicts.prev);
-   LL_Add(&active_edicts, e, next, prev);
+   G_ActivateEdict(e);
    assert(e->next);
    assert(e->prev);
 
@@ -1305,14 +1311,12 @@ void G_FreeEdict(edict_t *ed)
 
    // unlink from world
    gi.unlinkentity(ed);
+   G_RadiusUnlink(ed);
 
    assert(ed->next);
    assert(ed->prev);
 
-   if(level.next_edict == ed)
-   {
-      level.next_edict = ed->next;
-   }
+   G_SleepEdict(ed);
 
    LL_Remove(ed, next, prev);
 
@@ -21,6 +21,10 @@
 #include "windows.h"
 #include "ctf.h"
 
+#ifndef _WIN32
+#include <time.h>
+#endif
+
 cvar_t *g_numdebuglines;
 
 debugline_t *DebugLines = nullptr;
@@ -171,11 +175,156 @@ EXPORT_FROM_DLL void G_CalcBoundsOfMove(Vector &start, Vector &end, Vector &mins
    }
 }
 
+/*
+=================
+Trace cache
+
+When sv_tracecache is set, G_Trace and G_FullTrace keep their results for
+the rest of the frame so that identical traces (mostly AI visibility
+checks) only go to the server once.  Linking or unlinking any edict
+changes what a trace can hit, so gi.linkentity and gi.unlinkentity are
+wrapped to throw out everything that's been cached, and the cache is
+cleared at the start of every frame.  gi.setmodel links brush models
+inside the engine, so Entity::setModel clears the cache after calling it.
+
+Changing an edict's solid, owner or svflags without relinking it isn't
+noticed, which is why the cache is off by default.
+=================
+*/
+
+#define TRACECACHE_SIZE 1024  // must be a power of 2
+
+typedef struct
+{
+   unsigned  generation;
+   vec3_t    start;
+   vec3_t    mins;
+   vec3_t    maxs;
+   vec3_t    end;
+   float     radius;     // -1 for G_Trace
+   edict_t  *passent;
+   int       contentmask;
+   trace_t   trace;
+} tracecacheentry_t;
+
+static tracecacheentry_t  *traceCache = nullptr;
+
+// entries from an earlier generation are empty
+static unsigned            traceCacheGeneration = 1;
+
+static void (*engineLinkEntity)(edict_t *ent);
+static void (*engineUnlinkEntity)(edict_t *ent);
+
+static void G_TraceCacheLinkEntity(edict_t *ent)
+{
+   traceCacheGeneration++;
+   engineLinkEntity(ent);
+}
+
+static void G_TraceCacheUnlinkEntity(edict_t *ent)
+{
+   traceCacheGeneration++;
+   engineUnlinkEntity(ent);
+}
+
+void G_InitTraceCache(void)
+{
+   engineLinkEntity   = gi.linkentity;
+   engineUnlinkEntity = gi.unlinkentity;
+   gi.linkentity      = G_TraceCacheLinkEntity;
+   gi.unlinkentity    = G_TraceCacheUnlinkEntity;
+}
+
+void G_ClearTraceCache(void)
+{
+   traceCacheGeneration++;
+}
+
+static tracecacheentry_t *G_TraceCacheEntry(const tracecacheentry_t &key)
+{
+   const unsigned *words;
+   unsigned        hash;
+   int             i;
+
+   if(!traceCache)
+   {
+      traceCache = new tracecacheentry_t[TRACECACHE_SIZE];
+      memset(traceCache, 0, sizeof(tracecacheentry_t) * TRACECACHE_SIZE);
+   }
+
+   // hash the bits of the vectors, radius, passent and contentmask
+   words = (const unsigned *)key.start;
+   hash = 2166136261u;
+   for(i = 0; i < 13; i++)
+   {
+      hash = (hash ^ words[i]) * 16777619u;
+   }
+   hash = (hash ^ (unsigned)(size_t)key.passent) * 16777619u;
+   hash = (hash ^ (unsigned)key.contentmask) * 16777619u;
+
+   return &traceCache[(hash ^ (hash >> 16)) & (TRACECACHE_SIZE - 1)];
+}
+
+static trace_t G_CachedTrace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, float radius, edict_t *passent, int contentmask)
+{
+   tracecacheentry_t  key;
+   tracecacheentry_t *entry;
+
+   if(!sv_tracecache->value)
+   {
+      if(radius < 0)
+      {
+         return gi.trace(start, mins, maxs, end, passent, contentmask);
+      }
+
+      return gi.fulltrace(start, mins, maxs, end, radius, passent, contentmask);
+   }
+
+   memset(&key, 0, sizeof(key));
+   VectorCopy(start, key.start);
+   VectorCopy(end, key.end);
+   if(mins)
+   {
+      VectorCopy(mins, key.mins);
+   }
+   if(maxs)
+   {
+      VectorCopy(maxs, key.maxs);
+   }
+   key.radius = radius;
+   key.passent = passent;
+   key.contentmask = contentmask;
+
+   entry = G_TraceCacheEntry(key);
+   if((entry->generation == traceCacheGeneration) &&
+      !memcmp(entry->start, key.start, sizeof(vec3_t) * 4 + sizeof(float)) &&
+      (entry->passent == passent) && (entry->contentmask == contentmask))
+   {
+      sv_numcachedtraces++;
+      return entry->trace;
+   }
+
+   if(radius < 0)
+   {
+      key.trace = gi.trace(start, mins, maxs, end, passent, contentmask);
+   }
+   else
+   {
+      key.trace = gi.fulltrace(start, mins, maxs, end, radius, passent, contentmask);
+   }
+
+   // the trace itself can't link anything, so the generation is still good
+   key.generation = traceCacheGeneration;
+   *entry = key;
+
+   return key.trace;
+}
+
 EXPORT_FROM_DLL trace_t G_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, edict_t *passent, int contentmask, const char *reason)
 {
    trace_t trace;
 
-   trace = gi.trace(start, mins, maxs, end, passent, contentmask);
+   trace = G_CachedTrace(start, mins, maxs, end, -1, passent, contentmask);
    assert(!trace.ent || trace.ent->entity);
 
    if(sv_traceinfo->value > 1)
@@ -183,6 +332,10 @@ EXPORT_FROM_DLL trace_t G_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t e
       G_ShowTrace(&trace, passent, reason);
    }
    sv_numtraces++;
+   if(frameProfiling)
+   {
+      G_FrameProfileTrace(reason);
+   }
 
    if(sv_drawtrace->value)
    {
@@ -208,7 +361,7 @@ EXPORT_FROM_DLL trace_t G_Trace(Vector &start, Vector &mins, Vector &maxs, Vecto
       ent = passent->edict;
    }
 
-   trace = gi.trace(start.vec3(), mins.vec3(), maxs.vec3(), end.vec3(), ent, contentmask);
+   trace = G_CachedTrace(start.vec3(), mins.vec3(), maxs.vec3(), end.vec3(), -1, ent, contentmask);
 
    assert(!trace.ent || trace.ent->entity);
 
@@ -217,6 +370,10 @@ EXPORT_FROM_DLL trace_t G_Trace(Vector &start, Vector &mins, Vector &maxs, Vecto
       G_ShowTrace(&trace, ent, reason);
    }
    sv_numtraces++;
+   if(frameProfiling)
+   {
+      G_FrameProfileTrace(reason);
+   }
 
    if(sv_drawtrace->value)
    {
@@ -240,7 +397,7 @@ EXPORT_FROM_DLL trace_t G_FullTrace(Vector &start, Vector &mins, Vector &maxs, V
       ent = passent->edict;
    }
 
-   trace = gi.fulltrace(start.vec3(), mins.vec3(), maxs.vec3(), end.vec3(), radius, ent, contentmask);
+   trace = G_CachedTrace(start.vec3(), mins.vec3(), maxs.vec3(), end.vec3(), radius, ent, contentmask);
    assert(!trace.ent || trace.ent->entity);
 
    if(sv_traceinfo->value > 1)
@@ -248,6 +405,10 @@ EXPORT_FROM_DLL trace_t G_FullTrace(Vector &start, Vector &mins, Vector &maxs, V
       G_ShowTrace(&trace, ent, reason);
    }
    sv_numtraces++;
+   if(frameProfiling)
+   {
+      G_FrameProfileTrace(reason);
+   }
 
    if(sv_drawtrace->value)
    {
@@ -261,7 +422,7 @@ EXPORT_FROM_DLL trace_t G_FullTrace(vec3_t start, vec3_t mins, vec3_t maxs, vec3
 {
    trace_t trace;
 
-   trace = gi.fulltrace(start, mins, maxs, end, radius, passent, contentmask);
+   trace = G_CachedTrace(start, mins, maxs, end, radius, passent, contentmask);
    assert(!trace.ent || trace.ent->entity);
 
    if(sv_traceinfo->value > 1)
@@ -269,6 +430,10 @@ EXPORT_FROM_DLL trace_t G_FullTrace(vec3_t start, vec3_t mins, vec3_t maxs, vec3
       G_ShowTrace(&trace, passent, reason);
    }
    sv_numtraces++;
+   if(frameProfiling)
+   {
+      G_FrameProfileTrace(reason);
+   }
 
    if(sv_drawtrace->value)
    {
@@ -278,6 +443,208 @@ EXPORT_FROM_DLL trace_t G_FullTrace(vec3_t start, vec3_t mins, vec3_t maxs, vec3
    return trace;
 }
 
+/*
+=================
+Batched traces
+
+G_TraceBatch runs a whole set of traces and hands back all the results at
+once.  By default the traces are just run one after another through the
+same path as G_Trace, but the batch function can be replaced
+(G_SetTraceBatchFunc) with one that runs them in parallel or against a
+local collision world.  Back ends only fill in the results; the counting
+and debug output are done here.
+
+Results are only good until something links or unlinks.  Callers that
+change the world while working through their results (by damaging what
+was hit, for instance) should check G_TraceGeneration before using each
+one, and trace again if it has changed.
+=================
+*/
+
+static void G_DefaultTraceBatch(const tracerequest_t *requests, trace_t *results, int count)
+{
+   tracerequest_t req;
+   int            i;
+
+   for(i = 0; i < count; i++)
+   {
+      // the engine doesn't take const vectors
+      req = requests[i];
+      results[i] = G_CachedTrace(req.start, req.mins, req.maxs, req.end, req.full ? req.radius : -1,
+                                 req.passent, req.contentmask);
+   }
+}
+
+static tracebatchfunc_t traceBatchFunc = G_DefaultTraceBatch;
+
+EXPORT_FROM_DLL void G_SetTraceBatchFunc(tracebatchfunc_t func)
+{
+   traceBatchFunc = func ? func : G_DefaultTraceBatch;
+}
+
+EXPORT_FROM_DLL unsigned G_TraceGeneration(void)
+{
+   return traceCacheGeneration;
+}
+
+EXPORT_FROM_DLL void G_SetTraceRequest(tracerequest_t *req, const Vector &start, const Vector &mins, const Vector &maxs,
+                                       const Vector &end, Entity *passent, int contentmask, const char *reason)
+{
+   assert(reason);
+
+   start.copyTo(req->start);
+   mins.copyTo(req->mins);
+   maxs.copyTo(req->maxs);
+   end.copyTo(req->end);
+   req->full = false;
+   req->radius = 0;
+   req->passent = passent ? passent->edict : NULL;
+   req->contentmask = contentmask;
+   req->reason = reason;
+}
+
+EXPORT_FROM_DLL void G_SetFullTraceRequest(tracerequest_t *req, const Vector &start, const Vector &mins, const Vector &maxs,
+                                           const Vector &end, float radius, Entity *passent, int contentmask, const char *reason)
+{
+   G_SetTraceRequest(req, start, mins, maxs, end, passent, contentmask, reason);
+   req->full = true;
+   req->radius = radius;
+}
+
+EXPORT_FROM_DLL void G_TraceBatch(const tracerequest_t *requests, trace_t *results, int count)
+{
+   const tracerequest_t *req;
+   int                   i;
+
+   if(count <= 0)
+   {
+      return;
+   }
+
+   traceBatchFunc(requests, results, count);
+
+   for(i = 0; i < count; i++)
+   {
+      req = &requests[i];
+      assert(!results[i].ent || results[i].ent->entity);
+
+      if(sv_traceinfo->value > 1)
+      {
+         G_ShowTrace(&results[i], req->passent, req->reason);
+      }
+      sv_numtraces++;
+      if(frameProfiling)
+      {
+         G_FrameProfileTrace(req->reason);
+      }
+
+      if(sv_drawtrace->value)
+      {
+         if(req->full)
+         {
+            G_DebugLine(Vector(req->start), Vector(req->end), 0, 1, 1, 1);
+         }
+         else
+         {
+            G_DebugLine(Vector(req->start), Vector(req->end), 1, 1, 0, 1);
+         }
+      }
+   }
+}
+
+/*
+=================
+G_TraceBenchCommand
+
+Runs the same set of random traces out from the player (or the world
+origin) one at a time through G_Trace and then as one batch, and prints
+how long each took.  The trace cache is cleared before each run.
+
+  sv tracebench [count]
+=================
+*/
+EXPORT_FROM_DLL void G_TraceBenchCommand(void)
+{
+   tracerequest_t *requests;
+   trace_t        *single;
+   trace_t        *batched;
+   Vector          org;
+   Vector          dir;
+   Entity         *passent;
+   unsigned        start;
+   unsigned        singletime;
+   unsigned        batchtime;
+   int             count;
+   int             mismatches;
+   int             i;
+
+   count = 1000;
+   if(gi.argc() > 2)
+   {
+      count = atoi(gi.argv(2));
+   }
+
+   if((count < 1) || (count > 65536))
+   {
+      gi.printf("Usage: sv tracebench [1-65536]\n");
+      return;
+   }
+
+   passent = NULL;
+   org = vec_zero;
+   if(g_edicts[1].inuse && g_edicts[1].entity)
+   {
+      passent = g_edicts[1].entity;
+      org = passent->worldorigin + Vector(0, 0, passent->viewheight);
+   }
+
+   requests = new tracerequest_t[count];
+   single = new trace_t[count];
+   batched = new trace_t[count];
+
+   for(i = 0; i < count; i++)
+   {
+      dir = Vector(G_CRandom(), G_CRandom(), G_CRandom());
+      dir.normalize();
+      G_SetTraceRequest(&requests[i], org, vec_zero, vec_zero, org + dir * 1024, passent, MASK_SHOT, "G_TraceBenchCommand");
+   }
+
+   G_ClearTraceCache();
+   start = G_Microseconds();
+   for(i = 0; i < count; i++)
+   {
+      single[i] = G_Trace(requests[i].start, requests[i].mins, requests[i].maxs, requests[i].end,
+                          requests[i].passent, requests[i].contentmask, requests[i].reason);
+   }
+   singletime = G_Microseconds() - start;
+
+   G_ClearTraceCache();
+   start = G_Microseconds();
+   G_TraceBatch(requests, batched, count);
+   batchtime = G_Microseconds() - start;
+
+   mismatches = 0;
+   for(i = 0; i < count; i++)
+   {
+      if((single[i].fraction != batched[i].fraction) || (single[i].ent != batched[i].ent))
+      {
+         mismatches++;
+      }
+   }
+
+   gi.printf("%d traces\n", count);
+   gi.printf("  single  : %8u us, %6.2f us per trace\n", singletime, (float)singletime / count);
+   gi.printf("  batched : %8u us, %6.2f us per trace\n", batchtime, (float)batchtime / count);
+   if(mismatches)
+   {
+      gi.printf("  %d results didn't match\n", mismatches);
+   }
+
+   delete [] requests;
+   delete [] single;
+   delete [] batched;
+}
+
 /*
 =======================================================================
 
@@ -903,6 +1270,253 @@ void G_InitEdict(edict_t *e)
    e->s.prevframe = -1;
 }
 
+/*
+=================
+Radius grid
+
+Entities are hashed into a uniform grid of cells by their centroid so that
+radius queries only have to look at the entities near the origin instead of
+every edict in the level.  Entities are placed in the grid whenever they're
+linked, and taken out when their edict is freed.  The world (edict 0) is
+never in the grid since findradius never returns it.
+
+Queries that would cover more cells than there are edicts fall back to
+walking the edicts.
+=================
+*/
+
+#define RADIUS_CELL_BITS   8     // 256 unit cells
+#define RADIUS_HASH_SIZE   4096
+#define RADIUS_HASH_MASK   ( RADIUS_HASH_SIZE - 1 )
+#define RADIUS_MAX_CELLS   512
+
+typedef struct
+{
+   int   bucket;        // hash bucket + 1, 0 when not in the grid
+   int   cell[3];
+   int   next;
+   int   prev;
+} radiuslink_t;
+
+static int           *radiusHash       = nullptr;
+static radiuslink_t  *radiusLinks      = nullptr;
+static int           *radiusCandidates = nullptr;
+static int            radiusMaxEnts    = 0;
+
+// bumped whenever an entity enters or leaves a cell, so that findradius
+// knows when the candidates from its last query are out of date
+static unsigned       radiusVersion    = 0;
+
+static struct
+{
+   Vector   org;
+   float    rad;
+   unsigned version;
+   int      count;
+   int      pos;
+   qboolean valid;
+} radiusCache;
+
+static inline int G_RadiusCellCoord(float v)
+{
+   return (int)floor(v) >> RADIUS_CELL_BITS;
+}
+
+static inline int G_RadiusBucket(int x, int y, int z)
+{
+   return (((unsigned)x * 73856093u) ^ ((unsigned)y * 19349663u) ^ ((unsigned)z * 83492791u)) & RADIUS_HASH_MASK;
+}
+
+// Called from G_AllocGameData, after TAG_GAME has been freed
+void G_AllocRadiusGrid(void)
+{
+   radiusMaxEnts    = game.maxentities;
+   radiusHash       = (int *)gi.TagMalloc(RADIUS_HASH_SIZE * sizeof(int), TAG_GAME);
+   radiusLinks      = (radiuslink_t *)gi.TagMalloc(radiusMaxEnts * sizeof(radiuslink_t), TAG_GAME);
+   radiusCandidates = (int *)gi.TagMalloc(radiusMaxEnts * sizeof(int), TAG_GAME);
+
+   G_ClearRadiusGrid();
+}
+
+void G_ClearRadiusGrid(void)
+{
+   assert(radiusHash);
+
+   memset(radiusHash, 0, RADIUS_HASH_SIZE * sizeof(int));
+   memset(radiusLinks, 0, radiusMaxEnts * sizeof(radiuslink_t));
+   radiusVersion++;
+   radiusCache.valid = false;
+}
+
+void G_RadiusUnlink(edict_t *ed)
+{
+   radiuslink_t *l;
+   int           num;
+
+   num = ed - g_edicts;
+   if(!radiusLinks || (num <= 0) || (num >= radiusMaxEnts))
+   {
+      return;
+   }
+
+   l = &radiusLinks[num];
+   if(!l->bucket)
+   {
+      return;
+   }
+
+   if(l->prev)
+   {
+      radiusLinks[l->prev].next = l->next;
+   }
+   else
+   {
+      radiusHash[l->bucket - 1] = l->next;
+   }
+
+   if(l->next)
+   {
+      radiusLinks[l->next].prev = l->prev;
+   }
+
+   l->bucket = 0;
+   l->next = 0;
+   l->prev = 0;
+   radiusVersion++;
+}
+
+void G_RadiusLink(Entity *ent)
+{
+   radiuslink_t *l;
+   int           num;
+   int           x;
+   int           y;
+   int           z;
+   int           bucket;
+
+   num = ent->entnum;
+   if(!radiusLinks || (num <= 0) || (num >= radiusMaxEnts))
+   {
+      return;
+   }
+
+   x = G_RadiusCellCoord(ent->centroid.x);
+   y = G_RadiusCellCoord(ent->centroid.y);
+   z = G_RadiusCellCoord(ent->centroid.z);
+
+   l = &radiusLinks[num];
+   if(l->bucket && (l->cell[0] == x) && (l->cell[1] == y) && (l->cell[2] == z))
+   {
+      // still in the same cell
+      return;
+   }
+
+   G_RadiusUnlink(ent->edict);
+
+   bucket = G_RadiusBucket(x, y, z);
+   l->bucket  = bucket + 1;
+   l->cell[0] = x;
+   l->cell[1] = y;
+   l->cell[2] = z;
+   l->prev    = 0;
+   l->next    = radiusHash[bucket];
+   if(l->next)
+   {
+      radiusLinks[l->next].prev = num;
+   }
+   radiusHash[bucket] = num;
+   radiusVersion++;
+}
+
+static int G_CompareEntNums(const void *a, const void *b)
+{
+   return *(const int *)a - *(const int *)b;
+}
+
+/*
+=================
+G_RadiusCandidates
+
+Fills radiusCandidates with the numbers of every entity in the cells that
+touch the sphere, sorted in edict order.  Returns -1 if the query is too
+large to be worth doing through the grid.
+=================
+*/
+static int G_RadiusCandidates(Vector &org, float rad)
+{
+   int mins[3];
+   int maxs[3];
+   int x;
+   int y;
+   int z;
+   int i;
+   int count;
+   int cells;
+   radiuslink_t *l;
+
+   if(!radiusLinks)
+   {
+      return -1;
+   }
+
+   for(i = 0; i < 3; i++)
+   {
+      mins[i] = G_RadiusCellCoord(org[i] - rad);
+      maxs[i] = G_RadiusCellCoord(org[i] + rad);
+   }
+
+   cells = (maxs[0] - mins[0] + 1) * (maxs[1] - mins[1] + 1) * (maxs[2] - mins[2] + 1);
+   if((cells <= 0) || (cells > RADIUS_MAX_CELLS) || (cells > globals.num_edicts))
+   {
+      return -1;
+   }
+
+   count = 0;
+   for(x = mins[0]; x <= maxs[0]; x++)
+   {
+      for(y = mins[1]; y <= maxs[1]; y++)
+      {
+         for(z = mins[2]; z <= maxs[2]; z++)
+         {
+            for(i = radiusHash[G_RadiusBucket(x, y, z)]; i; i = l->next)
+            {
+               l = &radiusLinks[i];
+
+               // skip anything that just shares the bucket
+               if((l->cell[0] == x) && (l->cell[1] == y) && (l->cell[2] == z))
+               {
+                  radiusCandidates[count++] = i;
+               }
+            }
+         }
+      }
+   }
+
+   if(count > 1)
+   {
+      qsort(radiusCandidates, count, sizeof(int), G_CompareEntNums);
+   }
+
+   return count;
+}
+
+static inline qboolean G_InRadius(edict_t *from, Vector &org, float r2)
+{
+   Vector eorg;
+
+   if(!from->inuse)
+   {
+      return false;
+   }
+
+   assert(from->entity);
+
+   eorg = org - from->entity->centroid;
+
+   // dot product returns length squared
+   return (eorg * eorg) <= r2;
+}
+
 /*
 =================
 findradius
@@ -910,13 +1524,21 @@ findradius
 Returns entities that have origins within a spherical area
 
 findradius (origin, radius)
+
+Callers step through the results by passing back the last entity returned,
+so the candidates from the grid are kept between calls for as long as the
+same query is being made and no entity has changed cells.  Distances are
+always checked against the entity's current position.
 =================
 */
 Entity *findradius(Entity *startent, Vector org, float rad)
 {
-   Vector	eorg;
    edict_t	*from;
    float		r2;
+   int      start;
+   int      lo;
+   int      hi;
+   int      mid;
 
    if(!startent)
    {
@@ -932,19 +1554,56 @@ Entity *findradius(Entity *startent, Vector org, float rad)
    r2 = rad * rad;
 
    assert(startent->edict);
-   for(from = startent->edict + 1; from < &g_edicts[globals.num_edicts]; from++)
+   start = startent->edict - g_edicts;
+
+   if(!radiusCache.valid || (radiusCache.version != radiusVersion) ||
+      (radiusCache.rad != rad) || (radiusCache.org != org))
    {
-      if(!from->inuse)
+      radiusCache.count = G_RadiusCandidates(org, rad);
+      radiusCache.org = org;
+      radiusCache.rad = rad;
+      radiusCache.version = radiusVersion;
+      radiusCache.pos = 0;
+      radiusCache.valid = true;
+   }
+
+   if(radiusCache.count < 0)
+   {
+      for(from = startent->edict + 1; from < &g_edicts[globals.num_edicts]; from++)
       {
-         continue;
+         if(G_InRadius(from, org, r2))
+         {
+            return from->entity;
+         }
       }
 
-      assert(from->entity);
+      return NULL;
+   }
 
-      eorg = org - from->entity->centroid;
+   // usually we're carrying on from the last entity we returned
+   if((radiusCache.pos <= 0) || (radiusCandidates[radiusCache.pos - 1] != start))
+   {
+      lo = 0;
+      hi = radiusCache.count;
+      while(lo < hi)
+      {
+         mid = (lo + hi) >> 1;
+         if(radiusCandidates[mid] <= start)
+         {
+            lo = mid + 1;
+         }
+         else
+         {
+            hi = mid;
+         }
+      }
+      radiusCache.pos = lo;
+   }
 
-      // dot product returns length squared
-      if((eorg * eorg) <= r2)
+   while(radiusCache.pos < radiusCache.count)
+   {
+      from = &g_edicts[radiusCandidates[radiusCache.pos++]];
+      if(G_InRadius(from, org, r2))
       {
          return from->entity;
       }
@@ -1583,10 +2242,12 @@ Like the man says...
 void G_LoadAndExecScript(const char *filename, const char *label)
 {
    ScriptThread *pThread;
+   GameScript   *scr;
 
-   if(gi.LoadFile(filename, NULL, 0) != -1)
+   scr = ScriptLib.GetScript(filename);
+   if(scr)
    {
-      pThread = Director.CreateThread(filename, LEVEL_SCRIPT, label);
+      pThread = Director.CreateThread(scr, label, LEVEL_SCRIPT);
       if(pThread)
       {
          // start right away
@@ -1848,6 +2509,51 @@ int G_Milliseconds(void)
 #endif
 }
 
+/*
+================
+G_Microseconds
+
+High resolution timer for profiling.  Wraps around every 71 minutes or so,
+so only use it to measure intervals.
+================
+*/
+unsigned G_Microseconds(void)
+{
+#ifdef _WIN32
+   static LARGE_INTEGER frequency;
+   static LARGE_INTEGER base;
+   LARGE_INTEGER        now;
+   LONGLONG             ticks;
+
+   if(!frequency.QuadPart)
+   {
+      QueryPerformanceFrequency(&frequency);
+      QueryPerformanceCounter(&base);
+   }
+
+   QueryPerformanceCounter(&now);
+   ticks = now.QuadPart - base.QuadPart;
+
+   // split into whole seconds first so the multiply can't overflow
+   return (unsigned)((ticks / frequency.QuadPart) * 1000000 + 
+                     ((ticks % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+#else
+   static struct timespec  base;
+   static qboolean         initialized = false;
+   struct timespec         now;
+
+   if(!initialized)
+   {
+      clock_gettime(CLOCK_MONOTONIC, &base);
+      initialized = true;
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return (unsigned)((now.tv_sec - base.tv_sec) * 1000000 + (now.tv_nsec - base.tv_nsec) / 1000);
+#endif
+}
+
 /*
 ===============
 G_DebugPrintf
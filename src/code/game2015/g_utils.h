@@ -17,9 +17,15 @@
 #define __G_UTILS_H__
 
 class Archiver;
+class Entity;
 
 EXPORT_FROM_DLL void       G_ArchiveEdict(Archiver &arc, edict_t *edict);
 EXPORT_FROM_DLL void       G_UnarchiveEdict(Archiver &arc, edict_t *edict);
+EXPORT_FROM_DLL void       G_RadiusLink(Entity *ent);
+EXPORT_FROM_DLL void       G_ActivateEdict(edict_t *e);
+EXPORT_FROM_DLL void       G_WakeEdict(edict_t *e);
+EXPORT_FROM_DLL void       G_SleepEdict(edict_t *e);
+EXPORT_FROM_DLL void       G_ResetAwakeEdicts(void);
 
 #include "entity.h"
 
@@ -42,6 +48,31 @@ EXPORT_FROM_DLL trace_t    G_Trace(Vector &start, Vector &mins, Vector &maxs, Ve
 EXPORT_FROM_DLL trace_t    G_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, edict_t *passent, int contentmask, const char *reason);
 EXPORT_FROM_DLL trace_t    G_FullTrace(Vector &start, Vector &mins, Vector &maxs, Vector &end, float radius, Entity *passent, int contentmask, const char *reason);
 EXPORT_FROM_DLL trace_t    G_FullTrace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, float radius, edict_t *passent, int contentmask, const char *reason);
+EXPORT_FROM_DLL void       G_InitTraceCache(void);
+EXPORT_FROM_DLL void       G_ClearTraceCache(void);
+
+// A trace for G_TraceBatch.  Full traces are the same as G_FullTrace.
+typedef struct
+{
+   vec3_t      start;
+   vec3_t      mins;
+   vec3_t      maxs;
+   vec3_t      end;
+   qboolean    full;
+   float       radius;
+   edict_t    *passent;
+   int         contentmask;
+   const char *reason;
+} tracerequest_t;
+
+typedef void (*tracebatchfunc_t)(const tracerequest_t *requests, trace_t *results, int count);
+
+EXPORT_FROM_DLL void       G_SetTraceRequest(tracerequest_t *req, const Vector &start, const Vector &mins, const Vector &maxs, const Vector &end, Entity *passent, int contentmask, const char *reason);
+EXPORT_FROM_DLL void       G_SetFullTraceRequest(tracerequest_t *req, const Vector &start, const Vector &mins, const Vector &maxs, const Vector &end, float radius, Entity *passent, int contentmask, const char *reason);
+EXPORT_FROM_DLL void       G_TraceBatch(const tracerequest_t *requests, trace_t *results, int count);
+EXPORT_FROM_DLL void       G_SetTraceBatchFunc(tracebatchfunc_t func);
+EXPORT_FROM_DLL unsigned   G_TraceGeneration(void);
+EXPORT_FROM_DLL void       G_TraceBenchCommand(void);
 
 //###
 //EXPORT_FROM_DLL void     SelectSpawnPoint( Vector &origin, Vector &angles, int *gravaxis = NULL );
@@ -58,6 +89,9 @@ EXPORT_FROM_DLL qboolean   KillBox(Entity *ent);
 EXPORT_FROM_DLL qboolean   IsNumeric(const char *str);
 
 EXPORT_FROM_DLL Entity     *findradius(Entity *startent, Vector org, float rad);
+EXPORT_FROM_DLL void       G_RadiusUnlink(edict_t *ed);
+EXPORT_FROM_DLL void       G_AllocRadiusGrid(void);
+EXPORT_FROM_DLL void       G_ClearRadiusGrid(void);
 EXPORT_FROM_DLL Entity     *findclientsinradius(Entity *startent, Vector org, float rad);
 EXPORT_FROM_DLL const char *G_GetNameForSurface(csurface_t *s);
 
@@ -82,6 +116,7 @@ EXPORT_FROM_DLL void G_LoadAndExecScript(const char *filename, const char *label
 EXPORT_FROM_DLL ScriptThread *ExecuteThread(str thread_name, qboolean start = true);
 
 EXPORT_FROM_DLL int  G_Milliseconds(void);
+EXPORT_FROM_DLL unsigned G_Microseconds(void);
 EXPORT_FROM_DLL void G_DebugPrintf(const char *fmt, ...);
 
 //==================================================================
@@ -18,6 +18,7 @@
 #include "script.h"
 #include "gamescript.h"
 #include "../elib/qstringmap.h" // haleyjd 20170608
+#include "../elib/qstring.h"
 
 ScriptLibrarian ScriptLib;
 
@@ -35,6 +36,54 @@ ResponseDef ScriptLibrarian::Responses[] =
    { NULL, NULL }
 };
 
+/*
+==============
+=
+= G_InternScriptString
+=
+= Returns a single shared copy of the string.  Compiled scripts keep their
+= tokens here so that the same name in several scripts is only stored once.
+= Interned strings are never freed.
+=
+==============
+*/
+
+#define SCRIPT_INTERN_HASHSIZE 4096
+
+typedef struct internstring_s
+{
+   struct internstring_s *next;
+   unsigned               hash;
+   char                   string[1];
+} internstring_t;
+
+static internstring_t *internHash[SCRIPT_INTERN_HASHSIZE];
+
+const char *G_InternScriptString(const char *string)
+{
+   internstring_t *s;
+   unsigned        hash;
+   size_t          len;
+
+   hash = qstring::HashCodeCaseStatic(string);
+   for(s = internHash[hash % SCRIPT_INTERN_HASHSIZE]; s; s = s->next)
+   {
+      if((s->hash == hash) && !strcmp(s->string, string))
+      {
+         return s->string;
+      }
+   }
+
+   len = strlen(string);
+   s = (internstring_t *)malloc(sizeof(internstring_t) + len);
+   s->hash = hash;
+   memcpy(s->string, string, len + 1);
+   s->next = internHash[hash % SCRIPT_INTERN_HASHSIZE];
+   internHash[hash % SCRIPT_INTERN_HASHSIZE] = s;
+
+   return s->string;
+}
+
 // haleyjd 20170608: efficient map for fast lookups
 using keyfunc_t = const char *(*)(GameScript *);
 class ScriptMap : public qstringmap<GameScript *, keyfunc_t>
@@ -75,6 +124,7 @@ void ScriptLibrarian::CloseScripts(void)
       delete scr;
    }
    scriptMap->clear();
+   generation++;
 }
 
 void ScriptLibrarian::ClearMap()
@@ -89,6 +139,11 @@ void ScriptLibrarian::AddToMap(GameScript *script)
 
 void ScriptLibrarian::SetDialogScript(str scriptname)
 {
+   if(dialog_script != scriptname)
+   {
+      // "dialog::label" jumps now go somewhere else
+      generation++;
+   }
    dialog_script = scriptname;
 }
 
@@ -117,10 +172,14 @@ GameScript *ScriptLibrarian::GetScript(const char *name)
 
    n = G_FixSlashes(name);
    scr = FindScript(n.c_str());
-   if(!scr && (gi.LoadFile(name, nullptr, 0) != -1))
+   if(!scr)
    {
       scr = new GameScript();
-      scr->LoadFile(n.c_str());
+      if(!scr->OpenFile(n.c_str()))
+      {
+         delete scr;
+         return nullptr;
+      }
       scripts.AddObject(scr);
       scriptMap->insert(scr);
    }
@@ -128,12 +187,69 @@ GameScript *ScriptLibrarian::GetScript(const char *name)
    return scr;
 }
 
-qboolean ScriptLibrarian::Goto(GameScript *scr, const char *name)
+/*
+==============
+=
+= PrintLoadTimes
+=
+= Lists how long each loaded script took to read from disk and to compile
+= or read from the script cache.
+=
+==============
+*/
+void ScriptLibrarian::PrintLoadTimes(void)
+{
+   GameScript *scr;
+   unsigned    load;
+   unsigned    parse;
+   int         cached;
+   int         num;
+   int         i;
+
+   load   = 0;
+   parse  = 0;
+   cached = 0;
+
+   gi.printf("  load ms  parse ms  source    file\n");
+   num = scripts.NumObjects();
+   for(i = 1; i <= num; i++)
+   {
+      scr = scripts.ObjectAt(i);
+      gi.printf("%9.2f %9.2f  %-8s  %s\n", scr->loadTime / 1000.0f, scr->parseTime / 1000.0f,
+         scr->fromCache ? "cache" : "compiled", scr->Filename());
+
+      load  += scr->loadTime;
+      parse += scr->parseTime;
+      if(scr->fromCache)
+      {
+         cached++;
+      }
+   }
+
+   gi.printf("%d scripts, %d from cache, %.2f ms loading, %.2f ms parsing\n",
+      num, cached, load / 1000.0f, parse / 1000.0f);
+}
+
+//
+// When ref is given, a "file::label" jump is remembered in it so that the
+// next jump through the same ref skips looking up the script and the label.
+//
+qboolean ScriptLibrarian::Goto(GameScript *scr, const char *name, scriptlabelref_t *ref)
 {
    const char *p;
    GameScript *s;
    str n;
 
+   if(ref && ref->label && (ref->generation == generation))
+   {
+      if(scr->sourcescript != ref->script)
+      {
+         scr->SetSourceScript(ref->script);
+      }
+      scr->GotoLabel(ref->label);
+      return true;
+   }
+
    p = strstr(name, "::");
    if(!p)
    {
@@ -156,6 +272,12 @@ qboolean ScriptLibrarian::Goto(GameScript *scr, const char *name)
       if(s->labelExists(p))
       {
          scr->SetSourceScript(s);
+         if(ref)
+         {
+            ref->generation = generation;
+            ref->script     = s;
+            ref->label      = s->FindLabel(p);
+         }
          return scr->Goto(p);
       }
    }
@@ -227,9 +349,15 @@ GameScript::~GameScript()
 void GameScript::Close(void)
 {
    FreeLabels();
+   FreeProgram();
    Script::Close();
    sourcescript = this;
    crc = 0;
+   instruction = 0;
+   instructionToken = 0;
+   loadTime = 0;
+   parseTime = 0;
+   fromCache = false;
 }
 
 void GameScript::SetSourceScript(GameScript *scr)
@@ -264,16 +392,60 @@ void GameScript::FreeLabels(void)
    }
 }
 
-void GameScript::LoadFile(const char *name)
+/*
+==============
+=
+= OpenFile
+=
+= Loads and compiles the script, or reads the compiled form from the script
+= cache when it's up to date.  Returns false if the file doesn't exist.
+=
+==============
+*/
+qboolean GameScript::OpenFile(const char *name)
 {
+   const char *data;
+   unsigned    start;
+   int         len;
+
    // Convert all forward slashes to back slashes
    str n = G_FixSlashes(name);
 
+   Close();
+
+   start = G_Microseconds();
+   len = gi.LoadFile(n.c_str(), (void **)&data, TAG_GAME);
+   if(len < 0)
+   {
+      return false;
+   }
+
    sourcescript = this;
-   Script::LoadFile(n.c_str());
-   FindLabels();
+   Parse(data, len, n.c_str());
+   releaseBuffer = true;
 
    crc = gi.CalcCRC((const unsigned char*)buffer, length);
+   loadTime = G_Microseconds() - start;
+
+   start = G_Microseconds();
+   fromCache = ReadCache();
+   if(!fromCache)
+   {
+      FindLabels();
+      Compile();
+      WriteCache();
+   }
+   parseTime = G_Microseconds() - start;
+
+   return true;
+}
+
+void GameScript::LoadFile(const char *name)
+{
+   if(!OpenFile(name))
+   {
+      error("LoadFile", "Couldn't load %s\n", name);
+   }
 }
 
 void GameScript::FindLabels(void)
@@ -320,6 +492,666 @@ void GameScript::FindLabels(void)
    RestorePosition(&mark);
 }
 
+void GameScript::FreeProgram(void)
+{
+   if(program)
+   {
+      delete[] program->instructions;
+      delete[] program->tokens;
+      delete[] program->tokenends;
+      delete program;
+      program = nullptr;
+   }
+}
+
+static const char *scriptVarGroups[] = { "game", "level", "local", "parm", "console", nullptr };
+
+static void G_ClassifyInstruction(scriptinstruction_t *instr, const char **tokens)
+{
+   const char *name;
+   const char *command;
+   const char *dot;
+   int         len;
+   int         i;
+
+   name = tokens[0];
+   command = (instr->numtokens > 1) ? tokens[1] : "";
+   instr->eventnum = 0;
+
+   len = strlen(name);
+   if(len && (name[len - 1] == ':'))
+   {
+      instr->type = SCRIPT_INSTR_LABEL;
+      return;
+   }
+
+   // Same test as ScriptMaster::GetVarGroup
+   dot = strchr(name, '.');
+   if(dot)
+   {
+      len = dot - name;
+      for(i = 0; scriptVarGroups[i]; i++)
+      {
+         if((strlen(scriptVarGroups[i]) == (size_t)len) && !strncmp(name, scriptVarGroups[i], len))
+         {
+            instr->type = SCRIPT_INSTR_VARIABLE;
+            return;
+         }
+      }
+   }
+
+   switch(name[0])
+   {
+   case '$':
+      instr->type = SCRIPT_INSTR_OBJECT;
+      break;
+   case '@':
+      instr->type = SCRIPT_INSTR_SURFACE;
+      break;
+   case '%':
+      instr->type = SCRIPT_INSTR_CONSOLE;
+      break;
+   case '*':
+      instr->type = SCRIPT_INSTR_ENTNUM;
+      break;
+   default:
+      instr->type = SCRIPT_INSTR_GLOBAL;
+      command = name;
+      break;
+   }
+
+   instr->eventnum = Event::GetEventNum(command);
+}
+
+/*
+==============
+=
+= Compile
+=
+= Tokenizes the file one line at a time, the same way ScriptThread::Execute
+= used to, and stores the result as an array of instructions.  Must be called
+= after FindLabels.
+=
+==============
+*/
+void GameScript::Compile(void)
+{
+   Container<scriptinstruction_t> instrs;
+   Container<const char *>        toks;
+   Container<int>                 ends;
+   scriptinstruction_t            instr;
+   scriptmarker_t                 mark;
+   const char                    *tok;
+   int                            end;
+   int                            i;
+
+   FreeProgram();
+
+   MarkPosition(&mark);
+   Reset();
+
+   while(TokenAvailable(true))
+   {
+      instr.line       = GetLineNumber();
+      instr.firsttoken = toks.NumObjects();
+      while(TokenAvailable(false))
+      {
+         tok = G_InternScriptString(GetToken(false));
+         end = script_p - buffer;
+         toks.AddObject(tok);
+         ends.AddObject(end);
+      }
+      instr.numtokens = toks.NumObjects() - instr.firsttoken;
+      if(!instr.numtokens)
+      {
+         break;
+      }
+
+      G_ClassifyInstruction(&instr, toks.AddressOfObjectAt(instr.firsttoken + 1));
+      instrs.AddObject(instr);
+   }
+
+   RestorePosition(&mark);
+
+   program = new scriptprogram_t;
+   program->numinstructions = instrs.NumObjects();
+   program->numtokens       = toks.NumObjects();
+   program->instructions    = new scriptinstruction_t[program->numinstructions + 1];
+   program->tokens          = new const char *[program->numtokens + 1];
+   program->tokenends       = new int[program->numtokens + 1];
+   for(i = 0; i < program->numinstructions; i++)
+   {
+      program->instructions[i] = instrs.ObjectAt(i + 1);
+   }
+   for(i = 0; i < program->numtokens; i++)
+   {
+      program->tokens[i]    = toks.ObjectAt(i + 1);
+      program->tokenends[i] = ends.ObjectAt(i + 1);
+   }
+
+   // map the labels to the instruction following them
+   if(labelList)
+   {
+      for(script_label_t *label : *labelList)
+      {
+         SeekInstruction(label->pos.offset);
+         label->instruction = instruction;
+         label->token       = instructionToken;
+      }
+   }
+
+   MapLabels();
+
+   instruction      = 0;
+   instructionToken = 0;
+}
+
+/*
+==============
+=
+= MapLabels
+=
+= Marks each instruction with the label it falls under so the script
+= profiler can attribute it.  Labels are in file order, so this is one pass.
+=
+==============
+*/
+void GameScript::MapLabels(void)
+{
+   int label;
+   int numlabels;
+   int i;
+
+   numlabels = labelList ? labelList->NumObjects() : 0;
+
+   label = 0;
+   for(i = 0; i < program->numinstructions; i++)
+   {
+      while((label < numlabels) && (labelList->ObjectAt(label + 1)->instruction <= i))
+      {
+         label++;
+      }
+
+      program->instructions[i].label = label;
+   }
+}
+
+/*
+==============
+=
+= CacheHash
+=
+= The engine's CRC is only 16 bits, which isn't enough to be sure a cache
+= belongs to an edited script of the same length.
+=
+==============
+*/
+static unsigned CacheHash(const char *text, int len)
+{
+   unsigned hash;
+   int      i;
+
+   hash = 2166136261u;
+   for(i = 0; i < len; i++)
+   {
+      hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+   }
+
+   return hash;
+}
+
+/*
+==============
+=
+= CacheName
+=
+==============
+*/
+str GameScript::CacheName(void)
+{
+   str name;
+   int i;
+
+   name = "scriptcache/";
+   name += filename;
+   name += ".cache";
+   for(i = 0; i < name.length(); i++)
+   {
+      if(name[i] == '\\')
+      {
+         name[i] = '/';
+      }
+   }
+
+   return name;
+}
+
+/*
+==============
+=
+= ReadCache
+=
+= Builds the label table and program from the script's cache file.  Returns
+= false if there's no cache, it's from a different version of the script, or
+= anything about it looks wrong, in which case the script gets compiled.
+=
+==============
+*/
+qboolean GameScript::ReadCache(void)
+{
+   const scriptcacheheader_t *header;
+   const scriptcachelabel_t  *labels;
+   const scriptcacheinstr_t  *instrs;
+   const int                 *ends;
+   const char                *strings;
+   const char                *s;
+   const char                *strings_end;
+   const char                *data;
+   script_label_t            *label;
+   str                        name;
+   int                        size;
+   int                        len;
+   int                        i;
+
+   if(!g_scriptcache->value)
+   {
+      return false;
+   }
+
+   name = CacheName();
+   size = gi.LoadFile(name.c_str(), (void **)&data, TAG_GAME);
+   if(size < 0)
+   {
+      return false;
+   }
+
+   header = (const scriptcacheheader_t *)data;
+   if((size < (int)sizeof(*header)) || (header->ident != SCRIPTCACHE_IDENT) ||
+      (header->version != SCRIPTCACHE_VERSION) || (header->crc != crc) || (header->length != length) ||
+      (header->hash != CacheHash(buffer, length)) ||
+      (header->numlabels < 0) || (header->numinstructions < 0) || (header->numtokens < 0) ||
+      (header->stringsize < 0) ||
+      (size != (int)(sizeof(*header) + header->numlabels * sizeof(scriptcachelabel_t) +
+      header->numinstructions * sizeof(scriptcacheinstr_t) + header->numtokens * sizeof(int) + header->stringsize)))
+   {
+      gi.TagFree((void *)data);
+      return false;
+   }
+
+   labels      = (const scriptcachelabel_t *)(header + 1);
+   instrs      = (const scriptcacheinstr_t *)(labels + header->numlabels);
+   ends        = (const int *)(instrs + header->numinstructions);
+   strings     = (const char *)(ends + header->numtokens);
+   strings_end = strings + header->stringsize;
+
+   // make sure every string is terminated and the counts all agree
+   s = strings;
+   for(i = 0; i < header->numlabels + header->numtokens; i++)
+   {
+      if(s >= strings_end)
+      {
+         break;
+      }
+      len = strnlen(s, strings_end - s);
+      if(s + len >= strings_end)
+      {
+         break;
+      }
+      s += len + 1;
+   }
+
+   if((i < header->numlabels + header->numtokens) || (s != strings_end))
+   {
+      gi.TagFree((void *)data);
+      return false;
+   }
+
+   for(i = 0; i < header->numinstructions; i++)
+   {
+      if((instrs[i].numtokens < 1) || (instrs[i].firsttoken < 0) ||
+         (instrs[i].firsttoken + instrs[i].numtokens > header->numtokens))
+      {
+         gi.TagFree((void *)data);
+         return false;
+      }
+   }
+
+   for(i = 0; i < header->numlabels; i++)
+   {
+      if((labels[i].offset < 0) || (labels[i].offset > length) ||
+         (labels[i].instruction < 0) || (labels[i].instruction > header->numinstructions) || (labels[i].token < 0))
+      {
+         gi.TagFree((void *)data);
+         return false;
+      }
+
+      // a label at the very end of the script has no tokens after it
+      if((labels[i].instruction == header->numinstructions) ?
+         (labels[i].token != 0) : (labels[i].token >= instrs[labels[i].instruction].numtokens))
+      {
+         gi.TagFree((void *)data);
+         return false;
+      }
+   }
+
+   FreeLabels();
+   FreeProgram();
+
+   labelList = new Container<script_label_t *>();
+   labelMap  = new GSLabelMap(labelKeyFunc);
+
+   s = strings;
+   for(i = 0; i < header->numlabels; i++)
+   {
+      label = new script_label_t();
+      label->pos.tokenready = labels[i].tokenready;
+      label->pos.offset     = labels[i].offset;
+      label->pos.line       = labels[i].line;
+      Q_strlcpy(label->pos.token, s, sizeof(label->pos.token));
+      label->labelname      = s;
+      label->instruction    = labels[i].instruction;
+      label->token          = labels[i].token;
+      labelList->AddObject(label);
+      labelMap->insert(label);
+
+      s += strlen(s) + 1;
+   }
+
+   program = new scriptprogram_t;
+   program->numinstructions = header->numinstructions;
+   program->numtokens       = header->numtokens;
+   program->instructions    = new scriptinstruction_t[program->numinstructions + 1];
+   program->tokens          = new const char *[program->numtokens + 1];
+   program->tokenends       = new int[program->numtokens + 1];
+
+   for(i = 0; i < program->numtokens; i++)
+   {
+      program->tokens[i]    = G_InternScriptString(s);
+      program->tokenends[i] = ends[i];
+
+      s += strlen(s) + 1;
+   }
+
+   for(i = 0; i < program->numinstructions; i++)
+   {
+      program->instructions[i].line       = instrs[i].line;
+      program->instructions[i].firsttoken = instrs[i].firsttoken;
+      program->instructions[i].numtokens  = instrs[i].numtokens;
+      G_ClassifyInstruction(&program->instructions[i], &program->tokens[instrs[i].firsttoken]);
+   }
+
+   gi.TagFree((void *)data);
+
+   MapLabels();
+
+   instruction      = 0;
+   instructionToken = 0;
+
+   return true;
+}
+
+/*
+==============
+=
+= WriteCache
+=
+==============
+*/
+void GameScript::WriteCache(void)
+{
+   scriptcacheheader_t header;
+   scriptcachelabel_t  cachelabel;
+   scriptcacheinstr_t  cacheinstr;
+   FILE               *f;
+   str                 name;
+   int                 i;
+
+   if(!g_scriptcache->value || !program || !labelList)
+   {
+      return;
+   }
+
+   name = gi.GameDir();
+   name += "/";
+   name += CacheName();
+
+   gi.CreatePath(name.c_str());
+   f = fopen(name.c_str(), "wb");
+   if(!f)
+   {
+      gi.dprintf("Couldn't write script cache %s\n", name.c_str());
+      return;
+   }
+
+   header.ident           = SCRIPTCACHE_IDENT;
+   header.version         = SCRIPTCACHE_VERSION;
+   header.crc             = crc;
+   header.hash            = CacheHash(buffer, length);
+   header.length          = length;
+   header.numlabels       = labelList->NumObjects();
+   header.numinstructions = program->numinstructions;
+   header.numtokens       = program->numtokens;
+   header.stringsize      = 0;
+   for(script_label_t *label : *labelList)
+   {
+      header.stringsize += label->labelname.length() + 1;
+   }
+   for(i = 0; i < program->numtokens; i++)
+   {
+      header.stringsize += strlen(program->tokens[i]) + 1;
+   }
+
+   fwrite(&header, sizeof(header), 1, f);
+
+   for(script_label_t *label : *labelList)
+   {
+      cachelabel.tokenready  = label->pos.tokenready;
+      cachelabel.offset      = label->pos.offset;
+      cachelabel.line        = label->pos.line;
+      cachelabel.instruction = label->instruction;
+      cachelabel.token       = label->token;
+      fwrite(&cachelabel, sizeof(cachelabel), 1, f);
+   }
+
+   for(i = 0; i < program->numinstructions; i++)
+   {
+      cacheinstr.line       = program->instructions[i].line;
+      cacheinstr.firsttoken = program->instructions[i].firsttoken;
+      cacheinstr.numtokens  = program->instructions[i].numtokens;
+      fwrite(&cacheinstr, sizeof(cacheinstr), 1, f);
+   }
+
+   fwrite(program->tokenends, sizeof(int), program->numtokens, f);
+
+   for(script_label_t *label : *labelList)
+   {
+      fwrite(label->labelname.c_str(), label->labelname.length() + 1, 1, f);
+   }
+   for(i = 0; i < program->numtokens; i++)
+   {
+      fwrite(program->tokens[i], strlen(program->tokens[i]) + 1, 1, f);
+   }
+
+   if(ferror(f))
+   {
+      fclose(f);
+      remove(name.c_str());
+      gi.dprintf("Couldn't write script cache %s\n", name.c_str());
+      return;
+   }
+
+   fclose(f);
+}
+
+/*
+==============
+=
+= SeekInstruction
+=
+= Finds the instruction holding the first token past the given file offset.
+= Used to map labels and saved positions into the compiled script.
+=
+==============
+*/
+void GameScript::SeekInstruction(int offset)
+{
+   const scriptprogram_t *prog;
+   int                    lo;
+   int                    hi;
+   int                    mid;
+
+   instruction      = 0;
+   instructionToken = 0;
+
+   prog = sourcescript->program;
+   if(!prog)
+   {
+      return;
+   }
+
+   lo = 0;
+   hi = prog->numtokens;
+   while(lo < hi)
+   {
+      mid = (lo + hi) / 2;
+      if(prog->tokenends[mid] <= offset)
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+
+   if(lo >= prog->numtokens)
+   {
+      instruction = prog->numinstructions;
+      return;
+   }
+
+   instructionToken = lo;
+
+   lo = 0;
+   hi = prog->numinstructions - 1;
+   while(lo < hi)
+   {
+      mid = (lo + hi + 1) / 2;
+      if(prog->instructions[mid].firsttoken <= instructionToken)
+      {
+         lo = mid;
+      }
+      else
+      {
+         hi = mid - 1;
+      }
+   }
+
+   instruction       = lo;
+   instructionToken -= prog->instructions[lo].firsttoken;
+}
+
+/*
+==============
+=
+= MarkInstruction
+=
+= Builds a script marker for the current instruction so that save games
+= store the same file offsets they did before scripts were compiled.
+=
+==============
+*/
+void GameScript::MarkInstruction(scriptmarker_t *mark)
+{
+   const scriptprogram_t *prog;
+   int                    tok;
+
+   prog = sourcescript->program;
+   if(!prog)
+   {
+      MarkPosition(mark);
+      return;
+   }
+
+   memset(mark, 0, sizeof(*mark));
+   mark->tokenready = false;
+
+   if(instruction < prog->numinstructions)
+   {
+      tok = prog->instructions[instruction].firsttoken + instructionToken;
+   }
+   else
+   {
+      tok = prog->numtokens;
+   }
+
+   if(tok > 0)
+   {
+      mark->offset = prog->tokenends[tok - 1];
+      if(instructionToken)
+      {
+         mark->line = prog->instructions[instruction].line;
+      }
+      else
+      {
+         mark->line = prog->instructions[instruction - 1].line;
+      }
+   }
+   else
+   {
+      mark->offset = 0;
+      mark->line = 1;
+   }
+}
+
+/*
+==============
+=
+= NextInstruction
+=
+= Returns the current instruction along with the tokens that haven't been
+= executed yet, and advances to the next one.  Normally the whole line is
+= returned, but after a goto to a label in the middle of a line only the
+= tokens following the label are.
+=
+==============
+*/
+EXPORT_FROM_DLL const scriptinstruction_t *GameScript::NextInstruction(int *numtokens, const char ***tokens)
+{
+   const scriptprogram_t     *prog;
+   const scriptinstruction_t *instr;
+
+   prog = sourcescript->program;
+   if(!prog || (instruction >= prog->numinstructions))
+   {
+      gi.error("End of token file reached prematurely reading %s\n", filename.c_str());
+   }
+
+   instr = &prog->instructions[instruction];
+   *tokens    = &prog->tokens[instr->firsttoken + instructionToken];
+   *numtokens = instr->numtokens - instructionToken;
+
+   instruction++;
+   instructionToken = 0;
+
+   return instr;
+}
+
+EXPORT_FROM_DLL const scriptprogram_t *GameScript::Program(void) const
+{
+   return sourcescript->program;
+}
+
+EXPORT_FROM_DLL const char *GameScript::LabelName(int label)
+{
+   if(!sourcescript->labelList || (label < 1) || (label > sourcescript->labelList->NumObjects()))
+   {
+      return "";
+   }
+
+   return sourcescript->labelList->ObjectAt(label)->labelname.c_str();
+}
+
 EXPORT_FROM_DLL qboolean GameScript::labelExists(const char *name)
 {
    if(!sourcescript->labelMap)
@@ -341,17 +1173,17 @@ EXPORT_FROM_DLL qboolean GameScript::labelExists(const char *name)
    return sourcescript->labelMap->contains(labelname.c_str());
 }
 
-EXPORT_FROM_DLL qboolean GameScript::Goto(const char *name)
+EXPORT_FROM_DLL const script_label_t *GameScript::FindLabel(const char *name)
 {
    if(!sourcescript->labelMap)
    {
-      return false;
+      return nullptr;
    }
 
    str labelname = name;
    if(!labelname.length())
    {
-      return false;
+      return nullptr;
    }
 
    if(labelname[labelname.length() - 1] != ':')
@@ -359,14 +1191,31 @@ EXPORT_FROM_DLL qboolean GameScript::Goto(const char *name)
       labelname += ":";
    }
 
-   script_label_t *label;
-   if((label = sourcescript->labelMap->find(labelname.c_str())))
+   return sourcescript->labelMap->find(labelname.c_str());
+}
+
+//
+// The label must come from the script we're sourced from
+//
+EXPORT_FROM_DLL void GameScript::GotoLabel(const script_label_t *label)
+{
+   RestorePosition((scriptmarker_t *)&label->pos);
+   instruction      = label->instruction;
+   instructionToken = label->token;
+}
+
+EXPORT_FROM_DLL qboolean GameScript::Goto(const char *name)
+{
+   const script_label_t *label;
+
+   label = FindLabel(name);
+   if(label)
    {
-      RestorePosition(&label->pos);
+      GotoLabel(label);
       return true;
    }
-   else
-      return false;
+
+   return false;
 }
 
 EXPORT_FROM_DLL void GameScript::Mark(GameScriptMarker *mark)
@@ -375,7 +1224,7 @@ EXPORT_FROM_DLL void GameScript::Mark(GameScriptMarker *mark)
    assert(sourcescript);
 
    mark->filename = sourcescript->Filename();
-   MarkPosition(&mark->scriptmarker);
+   MarkInstruction(&mark->scriptmarker);
 }
 
 EXPORT_FROM_DLL void GameScript::Restore(GameScriptMarker *mark)
@@ -396,6 +1245,7 @@ EXPORT_FROM_DLL void GameScript::Restore(GameScriptMarker *mark)
    }
 
    RestorePosition(&mark->scriptmarker);
+   SeekInstruction(mark->scriptmarker.offset);
 }
 
 // EOF
@@ -24,8 +24,106 @@ typedef struct
 {
    scriptmarker_t pos;
    str labelname;
+   int instruction;     // instruction and token the label resumes at
+   int token;
 } script_label_t;
 
+//
+// Compiled scripts
+//
+// Each line of a script is compiled once when the file is loaded into an
+// instruction holding its interned tokens, the kind of target the line
+// addresses, and the event number of its command.  Threads step through the
+// instruction array instead of re-lexing the text.
+//
+typedef enum
+{
+   SCRIPT_INSTR_LABEL,        // label line, ignored
+   SCRIPT_INSTR_GLOBAL,       // global command handled by the thread
+   SCRIPT_INSTR_VARIABLE,     // game., level., local., parm. or console. variable
+   SCRIPT_INSTR_OBJECT,       // $targetname
+   SCRIPT_INSTR_SURFACE,      // @surfacename
+   SCRIPT_INSTR_CONSOLE,      // %consolename
+   SCRIPT_INSTR_ENTNUM        // *entnum
+} scriptinstrtype_t;
+
+typedef struct
+{
+   int type;
+   int eventnum;        // 0 if the command was unknown when the script was compiled
+   int line;
+   int label;           // index of the label the instruction falls under, 0 if none
+   int firsttoken;
+   int numtokens;
+} scriptinstruction_t;
+
+typedef struct
+{
+   scriptinstruction_t  *instructions;
+   int                   numinstructions;
+   const char          **tokens;
+   int                  *tokenends;     // offset in the file just past each token
+   int                   numtokens;
+} scriptprogram_t;
+
+const char *G_InternScriptString(const char *string);
+
+class GameScript;
+
+//
+// A "file::label" jump that has already been looked up.  It stays valid until
+// the script library closes its scripts or changes the dialog script, either
+// of which bumps the library generation.
+//
+typedef struct
+{
+   unsigned              generation;
+   GameScript           *script;
+   const script_label_t *label;
+} scriptlabelref_t;
+
+//
+// Script cache
+//
+// The label table and instruction stream of every script that gets compiled
+// are written to scriptcache/<script>.cache in the game directory.  The next
+// time the script is loaded the cache is used instead if its CRC, a 32 bit
+// hash and the length all still match the script text.  Event numbers aren't
+// stored since they can change between builds; they're looked up again when
+// the cache is read.
+//
+#define SCRIPTCACHE_IDENT     (('C' << 24) + ('S' << 16) + ('S' << 8) + 'G')
+#define SCRIPTCACHE_VERSION   2
+
+typedef struct
+{
+   int      ident;
+   int      version;
+   unsigned crc;
+   unsigned hash;             // FNV-1a of the script text, since the CRC is only 16 bits
+   int      length;           // length of the script text
+   int      numlabels;
+   int      numinstructions;
+   int      numtokens;
+   int      stringsize;       // label names followed by the tokens, each null terminated
+} scriptcacheheader_t;
+
+typedef struct
+{
+   int tokenready;
+   int offset;
+   int line;
+   int instruction;
+   int token;
+} scriptcachelabel_t;
+
+typedef struct
+{
+   int line;
+   int firsttoken;
+   int numtokens;
+} scriptcacheinstr_t;
+
 class GameScript;
 
 class EXPORT_FROM_DLL GameScriptMarker : public Class
@@ -74,6 +172,25 @@ protected:
    GSLabelMap                  *labelMap     = nullptr;
    GameScript                  *sourcescript;
    unsigned                     crc          = 0;
+   scriptprogram_t             *program      = nullptr;
+   int                          instruction  = 0;
+   int                          instructionToken = 0;
+
+   // how long the file took to read and to turn into a program, in microseconds
+   unsigned                     loadTime     = 0;
+   unsigned                     parseTime    = 0;
+   qboolean                     fromCache    = false;
+
+   void              FreeProgram();
+   void              Compile();
+   str               CacheName();
+   qboolean          ReadCache();
+   void              WriteCache();
+   void              MapLabels();
+   void              SeekInstruction(int offset);
+   void              MarkInstruction(scriptmarker_t *mark);
+
+   friend class ScriptLibrarian;
 
 public:
    CLASS_PROTOTYPE(GameScript);
@@ -83,6 +200,7 @@ public:
    ~GameScript();
    void              Close();
    void              SetSourceScript(GameScript *scr);
+   qboolean          OpenFile(const char *filename);
    void              LoadFile(const char *filename);
 
    void              Mark(GameScriptMarker *mark);
@@ -91,7 +209,12 @@ public:
    void              FreeLabels();
    void              FindLabels();
    qboolean          labelExists(const char *name);
+   const script_label_t *FindLabel(const char *name);
+   void              GotoLabel(const script_label_t *label);
    qboolean          Goto(const char *name);
+   const scriptinstruction_t *NextInstruction(int *numtokens, const char ***tokens);
+   const scriptprogram_t *Program() const;
+   const char       *LabelName(int label);
    virtual void      Archive(Archiver &arc)   override;
    virtual void      Unarchive(Archiver &arc) override;
 };
@@ -107,6 +230,7 @@ class EXPORT_FROM_DLL ScriptLibrarian : public Class
 protected:
    Container<GameScript *>  scripts;
    ScriptMap               *scriptMap;
+   unsigned                 generation = 1;   // changes whenever scripts are freed or dialog_script changes
    str                      dialog_script;
    str                      game_script;
 
@@ -125,8 +249,9 @@ public:
    const char  *GetGameScript();
    GameScript  *FindScript(const char *name);
    GameScript  *GetScript(const char *name);
-   qboolean     Goto(GameScript *scr, const char *name);
+   qboolean     Goto(GameScript *scr, const char *name, scriptlabelref_t *ref = nullptr);
    qboolean     labelExists(GameScript *scr, const char *name);
+   void         PrintLoadTimes();
    virtual void Archive(Archiver &arc)   override;
    virtual void Unarchive(Archiver &arc) override;
 };
@@ -158,6 +283,7 @@ inline EXPORT_FROM_DLL void ScriptLibrarian::Unarchive(Archiver &arc)
 
    scripts.FreeObjectList();
    ClearMap();
+   generation++;
 
    arc.ReadInteger(&num);
    for(i = 1; i <= num; i++)
@@ -215,6 +341,7 @@ inline EXPORT_FROM_DLL void GameScript::Unarchive(Archiver &arc)
    }
 
    RestorePosition(&mark.scriptmarker);
+   SeekInstruction(mark.scriptmarker.offset);
 }
 
 #endif
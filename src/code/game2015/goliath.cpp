@@ -64,6 +64,7 @@ Goliath::Goliath() : Actor()
       actorthread->Vars()->SetVariable("attackstage", attackstage);
 
    flags |= FL_POSTTHINK;
+   Wake();
 }
 
 void Goliath::Prethink(void)
@@ -106,7 +107,7 @@ void Goliath::Prethink(void)
          if(bestent)
          {
             bestent = CheckObjectsAbove(bestent);
-            SetVariable("other", bestent);
+            SetVariable(otherVar, bestent);
             if(DoAction("throwthing", false))
             {
                randomthrowtime = 0;
@@ -210,7 +211,7 @@ void Goliath::Prethink(void)
             bestent = CheckObjectsAbove(bestent);
             if(bestent)
             {
-               SetVariable("other", bestent);
+               SetVariable(otherVar, bestent);
                if(DoAction("throwthing", false))
                {
                   randomthrowtime = 0;
@@ -236,7 +237,7 @@ void Goliath::Prethink(void)
             ent = CheckObjectsAbove(ent);
             if(ent)
             {
-               SetVariable("other", ent);
+               SetVariable(otherVar, ent);
                // if in attackstage 2, there's a chance we'll just smash it
                if((attackstage == 2) && (G_Random() < 0.6))
                   DoAction("destroyobstruction", false);
@@ -568,6 +568,7 @@ Hoverbike::Hoverbike() : Entity()
    }
 
    flags      |= FL_POSTTHINK;
+   Wake();
    // just marks this as a hoverbike to the game since
    // it's not attached to a parent
    edict->s.effects |= EF_HOVER; //***
@@ -734,6 +735,7 @@ void Hoverbike::BikeRespawn(Event *ev)
    sidemove     = 0;
    upmove       = 0;
    flags       |= FL_POSTTHINK;
+   Wake();
    edict->s.effects |= EF_HOVER;
 
    setOrigin(spawnspot);
@@ -17,6 +17,7 @@
 #include "scriptvariable.h"
 #include "worldspawn.h"
 #include "scriptmaster.h"
+#include "../elib/qstring.h"
 
 Event EV_Remove("immediateremove");
 Event EV_ScriptRemove("remove");
@@ -26,9 +27,50 @@ typedef struct eventcache_s
    Listener *obj;
    Event		*event;
    float		time;
+   unsigned	sequence;   // order the event was posted in.  Breaks ties between events with the same time.
+   int      heapindex;
 
    struct eventcache_s *next;
    struct eventcache_s *prev;
+
+   // other events pending on the same object
+   struct eventcache_s *objnext;
+   struct eventcache_s **objprev;
+
+   void LinkToObject()
+   {
+      objprev = &obj->pendingEvents;
+      objnext = obj->pendingEvents;
+      if(objnext)
+      {
+         objnext->objprev = &objnext;
+      }
+      obj->pendingEvents = this;
+   }
+
+   void UnlinkFromObject()
+   {
+      if(objprev)
+      {
+         *objprev = objnext;
+         if(objnext)
+         {
+            objnext->objprev = objprev;
+         }
+      }
+      objnext = NULL;
+      objprev = NULL;
+   }
+
+   static void ClearObject(Listener *obj)
+   {
+      obj->pendingEvents = NULL;
+   }
+
+   static struct eventcache_s *FirstOnObject(Listener *obj)
+   {
+      return obj->pendingEvents;
+   }
 } eventcache_t;
 
 #define MAX_EVENTS 2000
@@ -40,27 +82,30 @@ extern "C"
    cvar_t        *g_numevents;
 }
 
+// Pending events are kept in a binary heap ordered by time and then by the
+// order they were posted in, which gives the same dispatch order as the
+// sorted list it replaced without having to walk it on every post.
+static eventcache_t *EventHeap[MAX_EVENTS];
+static unsigned      eventSequence = 0;
+
 cvar_t *g_showevents;
 cvar_t *g_eventlimit;
 cvar_t *g_timeevents;
+cvar_t *g_profileevents;
 cvar_t *g_watch;
 
 eventcache_t FreeEventHead;
 eventcache_t *FreeEvents = &FreeEventHead;
-eventcache_t EventQueueHead =
-{
-   nullptr,         // obj
-   nullptr,         // event
-   0,               // time
-   &EventQueueHead, // next
-   &EventQueueHead  // prev
-};
-eventcache_t *EventQueue = &EventQueueHead;
 
 Container<str *> *Event::commandList = NULL;
 Container<int> *Event::flagList = NULL;
-Container<int> *Event::sortedList = NULL;
-qboolean Event::dirtylist = false;
+int *Event::hashTable = NULL;
+int Event::hashSize = 0;
+
+// How long it took to register all the event names during startup
+static unsigned eventRegisterTime = 0;
+
+unsigned eventsDispatched = 0;
 
 Event NullEvent;
 
@@ -82,6 +127,12 @@ ResponseDef Event::Responses[] =
    return 0;
 }
 
+ const char *Event::GetEventName(int eventnum)
+{
+   assert(commandList && (eventnum > 0) && (eventnum <= commandList->NumObjects()));
+   return commandList->ObjectAt(eventnum)->c_str();
+}
+
  int Event::compareEvents(const void *arg1, const void *arg2)
 {
    int ev1;
@@ -93,29 +144,55 @@ ResponseDef Event::Responses[] =
    return stricmp(commandList->ObjectAt(ev1)->c_str(), commandList->ObjectAt(ev2)->c_str());
 }
 
- void Event::SortEventList(void)
+//
+// Event names are kept in an open addressed, case insensitive hash table of 
+// event numbers.  Zero marks an empty slot, since the first event is 1.
+//
+ void Event::AddToHash(int eventnum)
 {
-   dirtylist = false;
+   int *oldtable;
+   int  oldsize;
+   int  h;
+   int  i;
 
-   if(sortedList && commandList)
+   // keep the table no more than half full
+   if((commandList->NumObjects() * 2) > hashSize)
    {
-#ifndef EXPORT_TEMPLATE
-      qsort((void *)sortedList->AddressOfObjectAt(1),
-         (size_t)sortedList->NumObjects(),
-            sizeof(int), compareEvents);
-#else
-      sortedList->Sort(compareEvents);
-#endif
+      oldtable = hashTable;
+      oldsize  = hashSize;
+
+      hashSize  = oldsize ? (oldsize * 2) : 1024;
+      hashTable = new int[hashSize];
+      memset(hashTable, 0, sizeof(int) * hashSize);
+
+      for(i = 0; i < oldsize; i++)
+      {
+         if(oldtable[i])
+         {
+            h = qstring::HashCodeStatic(commandList->ObjectAt(oldtable[i])->c_str()) & (hashSize - 1);
+            while(hashTable[h])
+            {
+               h = (h + 1) & (hashSize - 1);
+            }
+            hashTable[h] = oldtable[i];
+         }
+      }
+
+      delete [] oldtable;
+   }
+
+   h = qstring::HashCodeStatic(commandList->ObjectAt(eventnum)->c_str()) & (hashSize - 1);
+   while(hashTable[h])
+   {
+      h = (h + 1) & (hashSize - 1);
    }
+   hashTable[h] = eventnum;
 }
 
 inline  int Event::FindEvent(const char *name)
 {
    int eventnum;
-   int index;
-   int l;
-   int r;
-   int diff;
+   int h;
 
    assert(name);
    if(!name)
@@ -128,35 +205,46 @@ inline  int Event::FindEvent(const char *name)
       return 0;
    }
 
-   if(dirtylist)
-   {
-      SortEventList();
-   }
-
-   l = 1;
-   r = sortedList->NumObjects();
-   while(r >= l)
+   h = qstring::HashCodeStatic(name) & (hashSize - 1);
+   while((eventnum = hashTable[h]))
    {
-      index = (l + r) >> 1;
-      eventnum = sortedList->ObjectAt(index);
-      diff = stricmp(name, commandList->ObjectAt(eventnum)->c_str());
-      if(diff < 0)
-      {
-         r = index - 1;
-      }
-      else if(diff > 0)
-      {
-         l = index + 1;
-      }
-      else
+      if(!stricmp(name, commandList->ObjectAt(eventnum)->c_str()))
       {
          return eventnum;
       }
+      h = (h + 1) & (hashSize - 1);
    }
 
    return 0;
 }
 
+//
+// Adds a new event name and returns its number.  Used by the constructors 
+// when they're given a name that doesn't exist yet.
+//
+ int Event::RegisterEvent(const char *name, int flags)
+{
+   unsigned start;
+   int      eventnum;
+   str     *t;
+
+   start = G_Microseconds();
+
+   t = new str(name);
+   eventnum = commandList->AddObject(t);
+   // check for default flags
+   if(flags == -1)
+   {
+      flags = 0;
+   }
+   flagList->AddObject(flags);
+   AddToHash(eventnum);
+
+   eventRegisterTime += G_Microseconds() - start;
+
+   return eventnum;
+}
+
  int Event::FindEvent(str &name)
 {
    return FindEvent(name.c_str());
@@ -174,6 +262,7 @@ inline  int Event::FindEvent(const char *name)
    int p;
    int hidden;
    str text;
+   int *sorted;
 
    if(!commandList)
    {
@@ -181,10 +270,14 @@ inline  int Event::FindEvent(const char *name)
       return;
    }
 
-   if(dirtylist)
+   // the hash table has no order to it, so sort the list for printing
+   n = commandList->NumObjects();
+   sorted = new int[n];
+   for(i = 0; i < n; i++)
    {
-      SortEventList();
+      sorted[i] = i + 1;
    }
+   qsort(sorted, n, sizeof(int), compareEvents);
 
    l = 0;
    if(mask)
@@ -194,10 +287,9 @@ inline  int Event::FindEvent(const char *name)
 
    hidden = 0;
    num = 0;
-   n = sortedList->NumObjects();
-   for(i = 1; i <= n; i++)
+   for(i = 0; i < n; i++)
    {
-      eventnum = sortedList->ObjectAt(i);
+      eventnum = sorted[i];
       name = commandList->ObjectAt(eventnum)->c_str();
       flags = flagList->ObjectAt(eventnum);
 
@@ -228,6 +320,8 @@ inline  int Event::FindEvent(const char *name)
       gi.printf("%4d : %s%s\n", eventnum, text.c_str(), name.c_str());
    }
 
+   delete [] sorted;
+
    gi.printf("\n* = console command.\nC = cheat command.\n\n"
              "Printed %d of %d total commands.\n", num, n - hidden);
 
@@ -251,18 +345,152 @@ inline  int Event::FindEvent(const char *name)
    flagList = new Container<int>();
    flagList->AddObject(flags);
 
-   sortedList = new Container<int>();
-   sortedList->AddObject(NullEvent.eventnum);
-
-   dirtylist = false;
+   AddToHash(NullEvent.eventnum);
 
-   NullEvent.data = NULL;
    NullEvent.info.inuse = 0;
    NullEvent.info.source = EV_FROM_CODE;
    NullEvent.info.flags = 0;
    NullEvent.info.linenumber = 0;
 }
 
+/*
+===============================================================================
+
+Event pool
+
+Events are created and thrown away constantly (touches, damage, frame 
+commands, script commands), so they get a class slab of their own rather than
+sharing one with other classes of the same size.  Argument arrays and text 
+that don't fit inside the event are recycled from blocks that are kept around
+for the life of the game.
+
+===============================================================================
+*/
+
+#define EVENT_POOL_BLOCK   256
+#define EVENT_TEXT_CHUNK   128
+
+typedef struct eventpoolitem_s
+{
+   struct eventpoolitem_s *next;
+} eventpoolitem_t;
+
+typedef struct
+{
+   const char      *name;
+   size_t           size;      // size of each item
+   eventpoolitem_t *freelist;
+   int              numblocks;
+   int              inuse;
+   int              peak;
+   int              allocs;
+} eventpool_t;
+
+static classslab_t EventSlab     = { "events",     sizeof(Event), 0, 0, nullptr, nullptr, 0, 0, 0, 0, nullptr };
+static eventpool_t EventArgPool  = { "arg arrays", sizeof(eventarg_t) * EVENT_INLINE_ARGS * 2, nullptr, 0, 0, 0, 0 };
+static eventpool_t EventTextPool = { "text",       EVENT_TEXT_CHUNK,                            nullptr, 0, 0, 0, 0 };
+
+// number of times the event system had to go to the heap
+static int eventHeapAllocs = 0;
+
+/*
+===============================================================================
+
+Shared argument payloads
+
+When the same command goes out to a group of entities, ShareArgs moves the
+arguments into a reference counted block and each copy of the event points
+at it.  The block is never written to, so every argument's text is filled
+in first.  An event that gets more arguments added after sharing makes its
+own copy of them.
+
+===============================================================================
+*/
+
+typedef struct eventpayload_s
+{
+   int         refcount;
+   int         numargs;
+   eventarg_t  args[1];       // followed by the text for all the arguments
+} eventpayload_t;
+
+static int eventPayloads = 0;
+static int eventPayloadCopies = 0;
+
+static void EventPayload_Release(eventpayload_t *p)
+{
+   assert(p->refcount > 0);
+   if(--p->refcount == 0)
+   {
+      ::delete [] reinterpret_cast<byte *>(p);
+   }
+}
+
+static void *EventPool_Alloc(eventpool_t *pool)
+{
+   eventpoolitem_t *item;
+   byte            *block;
+   int              i;
+
+   if(!pool->freelist)
+   {
+      block = ::new byte[pool->size * EVENT_POOL_BLOCK];
+      for(i = EVENT_POOL_BLOCK - 1; i >= 0; i--)
+      {
+         item = reinterpret_cast<eventpoolitem_t *>(block + pool->size * i);
+         item->next = pool->freelist;
+         pool->freelist = item;
+      }
+
+      pool->numblocks++;
+      eventHeapAllocs++;
+   }
+
+   item = pool->freelist;
+   pool->freelist = item->next;
+
+   pool->allocs++;
+   pool->inuse++;
+   if(pool->inuse > pool->peak)
+   {
+      pool->peak = pool->inuse;
+   }
+
+   return item;
+}
+
+static void EventPool_Free(eventpool_t *pool, void *ptr)
+{
+   eventpoolitem_t *item;
+
+   assert(pool->inuse > 0);
+
+   item = reinterpret_cast<eventpoolitem_t *>(ptr);
+   item->next = pool->freelist;
+   pool->freelist = item;
+   pool->inuse--;
+}
+
+static void EventPool_Print(eventpool_t *pool)
+{
+   gi.printf("%-12s %8d %8d %8d %8d %10d\n", pool->name, pool->inuse, pool->peak,
+             pool->numblocks * EVENT_POOL_BLOCK, pool->numblocks * EVENT_POOL_BLOCK * (int)pool->size, 
+             pool->allocs);
+}
+
+EXPORT_FROM_DLL void G_PrintEventPoolStats(void)
+{
+   gi.printf("pool           in use     peak capacity    bytes     allocs\n");
+   gi.printf("------------ -------- -------- -------- -------- ----------\n");
+   gi.printf("%-12s %8d %8d %8d %8d %10d\n", EventSlab.name, EventSlab.inuse, EventSlab.peak,
+             EventSlab.numblocks * EventSlab.itemsperblock, EventSlab.numblocks * EventSlab.itemsperblock * EventSlab.itemsize,
+             EventSlab.allocs);
+   EventPool_Print(&EventArgPool);
+   EventPool_Print(&EventTextPool);
+   gi.printf("\n%d heap allocations\n", eventHeapAllocs);
+   gi.printf("%d shared argument blocks, %d argument copies avoided\n", eventPayloads, eventPayloadCopies);
+}
+
 Event::Event() : Class()
 {
    info.inuse      = 0;
@@ -293,7 +521,6 @@ Event::Event(int num) : Class()
    }
 
    eventnum = num;
-   data = NULL;
    info.inuse = 0;
    info.source = EV_FROM_CODE;
    info.linenumber = 0;
@@ -302,12 +529,8 @@ Event::Event(int num) : Class()
 
 Event::Event(const Event &ev) : Class()
 {
-   int num;
-   int i;
-
    eventnum = ev.eventnum;
    assert((eventnum > 0) && eventnum <= commandList->NumObjects());
-   data = NULL;
 
    name = commandList->ObjectAt(eventnum)->c_str();
    info.inuse      = 0;
@@ -316,25 +539,11 @@ Event::Event(const Event &ev) : Class()
    info.linenumber = ev.info.linenumber;
    threadnum       = ev.threadnum;
 
-   if(ev.data)
-   {
-      num = ev.data->NumObjects();
-
-      data = new Container<str>();
-      data->Resize(num);
-
-      for(i = 1; i <= num; i++)
-      {
-         data->AddObject(ev.data->ObjectAt(i));
-      }
-   }
+   CopyArgs(ev);
 }
 
 Event::Event(const Event *ev) : Class()
 {
-   int num;
-   int i;
-
    assert(ev);
    if(!ev)
    {
@@ -343,58 +552,33 @@ Event::Event(const Event *ev) : Class()
 
    eventnum = ev->eventnum;
    assert((eventnum > 0) && eventnum <= commandList->NumObjects());
-   data = NULL;
    name = commandList->ObjectAt(eventnum)->c_str();
    info.inuse      = 0;
    info.source     = ev->info.source;
    info.flags      = ev->info.flags;
    info.linenumber = ev->info.linenumber;
    threadnum       = ev->threadnum;
-   if(ev->data)
-   {
-      num = ev->data->NumObjects();
-
-      data = new Container<str>();
-      data->Resize(num);
 
-      for(i = 1; i <= num; i++)
-      {
-         data->AddObject(ev->data->ObjectAt(i));
-      }
-   }
+   CopyArgs(*ev);
 }
 
 Event::Event(const char *command, int flags) : Class()
 {
-   str c;
-   str *t;
-
    if(!commandList)
    {
       initCommandList();
    }
 
-   c = command;
-   eventnum = FindEvent(c);
+   eventnum = FindEvent(command);
    if(!eventnum)
    {
-      t = new str(c);
-      eventnum = commandList->AddObject(t);
-      // check for default flags
-      if(flags == -1)
-      {
-         flags = 0;
-      }
-      flagList->AddObject((int)flags);
-      sortedList->AddObject(eventnum);
-      dirtylist = true;
+      eventnum = RegisterEvent(command, flags);
    }
 
    // Use the name stored in the command list in case the string passed in 
    // is not in static memory.
    name = commandList->ObjectAt(eventnum)->c_str();
 
-   data = NULL;
    info.inuse = 0;
    info.source = EV_FROM_CODE;
    info.linenumber = 0;
@@ -421,8 +605,6 @@ Event::Event(const char *command, int flags) : Class()
 
 Event::Event(str &command, int flags) : Class()
 {
-   str *t;
-
    if(!commandList)
    {
       initCommandList();
@@ -431,22 +613,12 @@ Event::Event(str &command, int flags) : Class()
    eventnum = FindEvent(command);
    if(!eventnum)
    {
-      t = new str(command);
-      eventnum = commandList->AddObject(t);
-      // check for default flags
-      if(flags == -1)
-      {
-         flags = 0;
-      }
-      flagList->AddObject(flags);
-      sortedList->AddObject(eventnum);
-      dirtylist = true;
+      eventnum = RegisterEvent(command.c_str(), flags);
    }
 
    // Use the name stored in the command list since the string passed in 
    // is not in static memory.
    name = commandList->ObjectAt(eventnum)->c_str();
-   data = NULL;
    info.inuse = 0;
    info.source = EV_FROM_CODE;
    info.linenumber = 0;
@@ -473,189 +645,509 @@ Event::Event(str &command, int flags) : Class()
 
  Event::~Event()
 {
-   if(data)
-   {
-      delete data;
-      data = NULL;
-   }
+   ClearArgs();
 }
 
- void Event::SetThread(ScriptThread *thread)
+Event &Event::operator = (const Event &ev)
 {
-   if(thread)
-   {
-      threadnum = thread->ThreadNum();
-   }
-   else
+   if(this != &ev)
    {
-      threadnum = -1;
-   }
-}
+      eventnum  = ev.eventnum;
+      name      = ev.name;
+      info      = ev.info;
+      threadnum = ev.threadnum;
 
- ScriptThread *Event::GetThread(void)
-{
-   if(threadnum != -1)
-   {
-      return Director.GetThread(threadnum);
+      ClearArgs();
+      CopyArgs(ev);
    }
 
-   return NULL;
+   return *this;
 }
 
- void Event::Error(const char *fmt, ...)
+eventarg_t *Event::NewArg(eventargtype_t type)
 {
-   va_list       argptr;
-   char          text[1024];
-   ScriptThread *thread;
-   const char   *filename;
+   eventarg_t *newargs;
+   eventarg_t *arg;
 
-   va_start(argptr, fmt);
-   vsnprintf(text, sizeof(text), fmt, argptr);
-   va_end(argptr);
-
-   switch(GetSource())
+   if(payload)
    {
-   default:
-   case EV_FROM_CODE:
-      gi.dprintf("Game: '%s' : %s\n", getName().c_str(), text);
-      break;
+      UnshareArgs();
+   }
 
-   case EV_FROM_SCRIPT:
-      thread = GetThread();
-      filename = "Dead script";
-      if(thread)
+   if(numargs >= maxargs)
+   {
+      if(maxargs == EVENT_INLINE_ARGS)
       {
-         filename = thread->Filename();
+         newargs = reinterpret_cast<eventarg_t *>(EventPool_Alloc(&EventArgPool));
+      }
+      else
+      {
+         newargs = new eventarg_t[maxargs * 2];
+         eventHeapAllocs++;
       }
-      gi.dprintf("%s(%d): '%s' :\n%s\n", filename, info.linenumber, getName().c_str(), text);
-      break;
 
-   case EV_FROM_CONSOLE:
-      gi.cprintf(GetConsoleEdict(), PRINT_HIGH, "Console: '%s' : %s\n", getName().c_str(), text);
-      break;
+      memcpy(newargs, args, sizeof(eventarg_t) * numargs);
+      FreeArgArray();
+      args = newargs;
+      maxargs *= 2;
    }
+
+   arg = &args[numargs++];
+   memset(arg, 0, sizeof(*arg));
+   arg->type = (unsigned char)type;
+
+   return arg;
 }
 
- void Event::AddEntity(Entity *ent)
+eventarg_t *Event::GetArg(int pos)
 {
-   char text[128];
-
-   //assert( ent );
-   if(!ent)
-   {
-      snprintf(text, sizeof(text), "*0");
-   }
-   else
+   if((pos < 1) || (pos > numargs))
    {
-      snprintf(text, sizeof(text), "*%d", ent->entnum);
+      Error("Index %d out of range.", pos);
+      return NULL;
    }
-   AddString(text);
+
+   return &args[pos - 1];
 }
 
- qboolean Event::IsVectorAt(int pos)
+char *Event::AllocText(eventarg_t *arg, int size)
 {
-   const char *text;
-   ScriptVariable *var;
+   char *text;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   // Text is never moved once it's allocated since GetString and friends
+   // hand out pointers to it.
+   if(textused + size <= EVENT_INLINE_TEXT)
    {
-      Error("Index %d out of range.", pos);
-      return false;
+      text = &textbuf[textused];
+      textused += size;
    }
-
-   text = data->ObjectAt(pos).c_str();
-   assert(text);
-
-   var = Director.GetExistingVariable(text);
-   if(var)
+   else if(size <= EVENT_TEXT_CHUNK)
    {
-      text = var->stringValue();
+      text = reinterpret_cast<char *>(EventPool_Alloc(&EventTextPool));
+      arg->flags |= EVARG_HEAPTEXT;
    }
-
-   if(text[0] == '(')
+   else
    {
-      // probably a vector, so say that it is
-      return true;
+      text = new char[size];
+      arg->flags |= EVARG_HEAPTEXT;
+      eventHeapAllocs++;
    }
 
-   // not a vector
-   return false;
+   return text;
 }
 
- qboolean Event::IsEntityAt(int pos)
+void Event::SetArgText(eventarg_t *arg, const char *text)
 {
-   const char		*name;
-   int				t;
-   ScriptVariable *var;
+   char *t;
+   int   len;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   assert(text);
+   if(!text)
    {
-      Error("Index %d out of range.", pos);
-      return false;
+      text = "";
    }
 
-   name = data->ObjectAt(pos).c_str();
-   assert(name);
+   len = strlen(text) + 1;
+   t = AllocText(arg, len);
+   memcpy(t, text, len);
+   arg->text = t;
+}
 
-   var = Director.GetExistingVariable(name);
-   if(var)
+const char *Event::ArgText(eventarg_t *arg)
+{
+   char text[128];
+
+   if(arg->text)
    {
-      name = var->stringValue();
+      return arg->text;
    }
 
-   if(name[0] == '$')
+   // Same formatting the Add functions used back when every argument was a string
+   switch(arg->type)
    {
-      t = G_FindTarget(0, &name[1]);
-      if(!t)
-      {
-         Error("Entity with targetname of '%s' not found", &name[1]);
+   case EVARG_INTEGER:
+      snprintf(text, sizeof(text), "%d", arg->integer);
+      break;
 
-         return false;
-      }
-   }
-   else
-   {
-      if(name[0] != '*')
-      {
-         Error("Expecting a '*'-prefixed entity number but found '%s'.", name);
+   case EVARG_FLOAT:
+      snprintf(text, sizeof(text), "%f", arg->value);
+      break;
 
-         return false;
-      }
+   case EVARG_VECTOR:
+      snprintf(text, sizeof(text), "(%f %f %f)", arg->vector[0], arg->vector[1], arg->vector[2]);
+      break;
 
-      if(!IsNumeric(&name[1]))
-      {
-         Error("Expecting a numeric value but found '%s'.", &name[1]);
+   case EVARG_ENTITY:
+      snprintf(text, sizeof(text), "*%d", arg->integer);
+      break;
 
-         return false;
-      }
-      else
-      {
-         t = atoi(&name[1]);
-      }
+   default:
+      text[0] = 0;
+      break;
    }
 
-   if((t < 0) || (t > game.maxentities))
-   {
-      Error("%d out of valid range for entity.", t);
-      return false;
-   }
+   SetArgText(arg, text);
 
-   // only return true if the entity exists
-   return (G_GetEntity(t) != NULL);
+   return arg->text;
+}
+
+void Event::CopyArgs(const Event &ev)
+{
+   if(ev.payload)
+   {
+      assert(!numargs && !payload);
+
+      payload = ev.payload;
+      payload->refcount++;
+      args    = payload->args;
+      numargs = payload->numargs;
+      maxargs = payload->numargs;
+      eventPayloadCopies++;
+      return;
+   }
+
+   CopyArgArray(ev.args, ev.numargs);
+}
+
+void Event::CopyArgArray(const eventarg_t *src, int num)
+{
+   eventarg_t *arg;
+   int         i;
+
+   for(i = 0; i < num; i++, src++)
+   {
+      arg = NewArg((eventargtype_t)src->type);
+      memcpy(arg->vector, src->vector, sizeof(arg->vector));
+
+      // Typed arguments regenerate their text if it's ever needed again
+      if(src->type == EVARG_STRING)
+      {
+         SetArgText(arg, src->text);
+      }
+   }
+}
+
+/*
+==============
+=
+= ShareArgs
+=
+= Moves the arguments into a shared block so that copies of this event
+= don't have to copy them.  Used when sending one command to many entities.
+=
+==============
+*/
+void Event::ShareArgs()
+{
+   eventpayload_t *p;
+   byte           *block;
+   char           *text;
+   int             textsize;
+   int             len;
+   int             i;
+
+   if(payload || !numargs)
+   {
+      return;
+   }
+
+   textsize = 0;
+   for(i = 0; i < numargs; i++)
+   {
+      textsize += strlen(ArgText(&args[i])) + 1;
+   }
+
+   block = ::new byte[sizeof(eventpayload_t) + sizeof(eventarg_t) * (numargs - 1) + textsize];
+   eventHeapAllocs++;
+   eventPayloads++;
+
+   p = reinterpret_cast<eventpayload_t *>(block);
+   p->refcount = 1;
+   p->numargs  = numargs;
+
+   text = reinterpret_cast<char *>(&p->args[numargs]);
+   for(i = 0; i < numargs; i++)
+   {
+      p->args[i] = args[i];
+      p->args[i].flags &= ~EVARG_HEAPTEXT;
+
+      len = strlen(args[i].text) + 1;
+      memcpy(text, args[i].text, len);
+      p->args[i].text = text;
+      text += len;
+   }
+
+   ClearArgs();
+
+   payload = p;
+   args    = p->args;
+   numargs = p->numargs;
+   maxargs = p->numargs;
+}
+
+//
+// Gives the event its own copy of its shared arguments so that it can be modified
+//
+void Event::UnshareArgs()
+{
+   eventpayload_t *p;
+
+   p = payload;
+   payload  = nullptr;
+   args     = argbuf;
+   numargs  = 0;
+   maxargs  = EVENT_INLINE_ARGS;
+   textused = 0;
+
+   CopyArgArray(p->args, p->numargs);
+   EventPayload_Release(p);
+}
+
+void Event::FreeArgArray()
+{
+   if(args == argbuf)
+   {
+      return;
+   }
+
+   if(maxargs == EVENT_INLINE_ARGS * 2)
+   {
+      EventPool_Free(&EventArgPool, args);
+   }
+   else
+   {
+      delete [] args;
+   }
+}
+
+void Event::ClearArgs()
+{
+   int i;
+
+   if(payload)
+   {
+      EventPayload_Release(payload);
+      payload  = nullptr;
+      args     = argbuf;
+      numargs  = 0;
+      maxargs  = EVENT_INLINE_ARGS;
+      textused = 0;
+      return;
+   }
+
+   for(i = 0; i < numargs; i++)
+   {
+      if(args[i].flags & EVARG_HEAPTEXT)
+      {
+         // text is never modified after it's set, so its length tells us where it came from
+         if(strlen(args[i].text) < EVENT_TEXT_CHUNK)
+         {
+            EventPool_Free(&EventTextPool, const_cast<char *>(args[i].text));
+         }
+         else
+         {
+            delete [] args[i].text;
+         }
+      }
+   }
+
+   FreeArgArray();
+
+   args     = argbuf;
+   numargs  = 0;
+   maxargs  = EVENT_INLINE_ARGS;
+   textused = 0;
+}
+
+ void Event::SetThread(ScriptThread *thread)
+{
+   if(thread)
+   {
+      threadnum = thread->ThreadNum();
+   }
+   else
+   {
+      threadnum = -1;
+   }
+}
+
+ ScriptThread *Event::GetThread(void)
+{
+   if(threadnum != -1)
+   {
+      return Director.GetThread(threadnum);
+   }
+
+   return NULL;
+}
+
+ void Event::Error(const char *fmt, ...)
+{
+   va_list       argptr;
+   char          text[1024];
+   ScriptThread *thread;
+   const char   *filename;
+
+   va_start(argptr, fmt);
+   vsnprintf(text, sizeof(text), fmt, argptr);
+   va_end(argptr);
+
+   switch(GetSource())
+   {
+   default:
+   case EV_FROM_CODE:
+      gi.dprintf("Game: '%s' : %s\n", getName().c_str(), text);
+      break;
+
+   case EV_FROM_SCRIPT:
+      thread = GetThread();
+      filename = "Dead script";
+      if(thread)
+      {
+         filename = thread->Filename();
+      }
+      gi.dprintf("%s(%d): '%s' :\n%s\n", filename, info.linenumber, getName().c_str(), text);
+      break;
+
+   case EV_FROM_CONSOLE:
+      gi.cprintf(GetConsoleEdict(), PRINT_HIGH, "Console: '%s' : %s\n", getName().c_str(), text);
+      break;
+   }
+}
+
+ void Event::AddEntity(Entity *ent)
+{
+   //assert( ent );
+   NewArg(EVARG_ENTITY)->integer = ent ? ent->entnum : 0;
+}
+
+ qboolean Event::IsVectorAt(int pos)
+{
+   const char *text;
+   eventarg_t *arg;
+   ScriptVariable *var;
+
+   arg = GetArg(pos);
+   if(!arg)
+   {
+      return false;
+   }
+
+   if(arg->type != EVARG_STRING)
+   {
+      return (arg->type == EVARG_VECTOR);
+   }
+
+   text = arg->text;
+   assert(text);
+
+   var = Director.GetExistingVariable(text);
+   if(var)
+   {
+      text = var->stringValue();
+   }
+
+   if(text[0] == '(')
+   {
+      // probably a vector, so say that it is
+      return true;
+   }
+
+   // not a vector
+   return false;
+}
+
+ qboolean Event::IsEntityAt(int pos)
+{
+   const char		*name;
+   int				t;
+   eventarg_t     *arg;
+   ScriptVariable *var;
+
+   arg = GetArg(pos);
+   if(!arg)
+   {
+      return false;
+   }
+
+   if(arg->type == EVARG_ENTITY)
+   {
+      t = arg->integer;
+   }
+   else
+   {
+      name = ArgText(arg);
+      assert(name);
+
+      if(arg->type == EVARG_STRING)
+      {
+         var = Director.GetExistingVariable(name);
+         if(var)
+         {
+            name = var->stringValue();
+         }
+      }
+
+      if(name[0] == '$')
+      {
+         t = G_FindTarget(0, &name[1]);
+         if(!t)
+         {
+            Error("Entity with targetname of '%s' not found", &name[1]);
+
+            return false;
+         }
+      }
+      else
+      {
+         if(name[0] != '*')
+         {
+            Error("Expecting a '*'-prefixed entity number but found '%s'.", name);
+
+            return false;
+         }
+
+         if(!IsNumeric(&name[1]))
+         {
+            Error("Expecting a numeric value but found '%s'.", &name[1]);
+
+            return false;
+         }
+         else
+         {
+            t = atoi(&name[1]);
+         }
+      }
+   }
+
+   if((t < 0) || (t > game.maxentities))
+   {
+      Error("%d out of valid range for entity.", t);
+      return false;
+   }
+
+   // only return true if the entity exists
+   return (G_GetEntity(t) != NULL);
 }
 
  qboolean Event::IsNumericAt(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return false;
    }
 
-   text = data->ObjectAt(pos).c_str();
+   if(arg->type != EVARG_STRING)
+   {
+      return (arg->type == EVARG_INTEGER) || (arg->type == EVARG_FLOAT);
+   }
+
+   text = arg->text;
    assert(text);
 
    var = Director.GetExistingVariable(text);
@@ -670,15 +1162,21 @@ Event::Event(str &command, int flags) : Class()
  const char *Event::GetString(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return "";
    }
 
-   text = data->ObjectAt(pos).c_str();
+   if(arg->type != EVARG_STRING)
+   {
+      return ArgText(arg);
+   }
+
+   text = arg->text;
    assert(text);
 
    var = Director.GetExistingVariable(text);
@@ -692,15 +1190,32 @@ Event::Event(str &command, int flags) : Class()
 EXPORT_FROM_DLL int Event::GetInteger(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return 0;
    }
 
-   text = data->ObjectAt(pos).c_str();
+   switch(arg->type)
+   {
+   case EVARG_INTEGER:
+      return arg->integer;
+
+   case EVARG_FLOAT:
+      return (int)arg->value;
+
+   case EVARG_STRING:
+      break;
+
+   default:
+      Error("Expecting a numeric value but found '%s'.", ArgText(arg));
+      return 0;
+   }
+
+   text = arg->text;
    assert(text);
 
    var = Director.GetExistingVariable(text);
@@ -725,15 +1240,32 @@ EXPORT_FROM_DLL int Event::GetInteger(int pos)
 EXPORT_FROM_DLL double Event::GetDouble(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return 0;
    }
 
-   text = data->ObjectAt(pos).c_str();
+   switch(arg->type)
+   {
+   case EVARG_INTEGER:
+      return (double)arg->integer;
+
+   case EVARG_FLOAT:
+      return (double)arg->value;
+
+   case EVARG_STRING:
+      break;
+
+   default:
+      Error("Expecting a numeric value but found '%s'.", ArgText(arg));
+      return 0;
+   }
+
+   text = arg->text;
    assert(text);
 
    var = Director.GetExistingVariable(text);
@@ -758,15 +1290,32 @@ EXPORT_FROM_DLL double Event::GetDouble(int pos)
 EXPORT_FROM_DLL float Event::GetFloat(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return 0;
    }
 
-   text = data->ObjectAt(pos).c_str();
+   switch(arg->type)
+   {
+   case EVARG_INTEGER:
+      return (float)arg->integer;
+
+   case EVARG_FLOAT:
+      return arg->value;
+
+   case EVARG_STRING:
+      break;
+
+   default:
+      Error("Expecting a numeric value but found '%s'.", ArgText(arg));
+      return 0;
+   }
+
+   text = arg->text;
    assert(text);
 
    var = Director.GetExistingVariable(text);
@@ -791,21 +1340,30 @@ EXPORT_FROM_DLL float Event::GetFloat(int pos)
 EXPORT_FROM_DLL Vector Event::GetVector(int pos)
 {
    const char *text;
+   eventarg_t *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return vec_zero;
    }
 
-   text = data->ObjectAt(pos).c_str();
-   assert(text);
+   if(arg->type == EVARG_VECTOR)
+   {
+      return Vector(arg->vector[0], arg->vector[1], arg->vector[2]);
+   }
 
-   var = Director.GetExistingVariable(text);
-   if(var)
+   text = ArgText(arg);
+   assert(text);
+
+   if(arg->type == EVARG_STRING)
    {
-      text = var->stringValue();
+      var = Director.GetExistingVariable(text);
+      if(var)
+      {
+         text = var->stringValue();
+      }
    }
 
    // Check if this is a ()-based vector
@@ -827,51 +1385,63 @@ EXPORT_FROM_DLL Entity *Event::GetEntity(int pos)
 {
    const char		*name;
    int				t;
+   eventarg_t     *arg;
    ScriptVariable *var;
 
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return NULL;
    }
 
-   name = data->ObjectAt(pos).c_str();
-   assert(name);
-
-   var = Director.GetExistingVariable(name);
-   if(var)
-   {
-      name = var->stringValue();
-   }
-
-   if(name[0] == '$')
+   if(arg->type == EVARG_ENTITY)
    {
-      t = G_FindTarget(0, &name[1]);
-      if(!t)
-      {
-         Error("Entity with targetname of '%s' not found", &name[1]);
-
-         return NULL;
-      }
+      // no need to go through the script variables for entities passed in from code
+      t = arg->integer;
    }
    else
    {
-      if(name[0] != '*')
-      {
-         Error("Expecting a '*'-prefixed entity number but found '%s'.", name);
+      name = ArgText(arg);
+      assert(name);
 
-         return NULL;
+      if(arg->type == EVARG_STRING)
+      {
+         var = Director.GetExistingVariable(name);
+         if(var)
+         {
+            name = var->stringValue();
+         }
       }
 
-      if(!IsNumeric(&name[1]))
+      if(name[0] == '$')
       {
-         Error("Expecting a numeric value but found '%s'.", &name[1]);
+         t = G_FindTarget(0, &name[1]);
+         if(!t)
+         {
+            Error("Entity with targetname of '%s' not found", &name[1]);
 
-         return NULL;
+            return NULL;
+         }
       }
       else
       {
-         t = atoi(&name[1]);
+         if(name[0] != '*')
+         {
+            Error("Expecting a '*'-prefixed entity number but found '%s'.", name);
+
+            return NULL;
+         }
+
+         if(!IsNumeric(&name[1]))
+         {
+            Error("Expecting a numeric value but found '%s'.", &name[1]);
+
+            return NULL;
+         }
+         else
+         {
+            t = atoi(&name[1]);
+         }
       }
    }
 
@@ -886,19 +1456,20 @@ EXPORT_FROM_DLL Entity *Event::GetEntity(int pos)
 
 EXPORT_FROM_DLL ScriptVariable *Event::GetVariable(int pos)
 {
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   eventarg_t *arg;
+
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return NULL;
    }
 
-   return Director.GetVariable(data->ObjectAt(pos).c_str());
+   return Director.GetVariable(ArgText(arg));
 }
 
 EXPORT_FROM_DLL void Event::Archive(Archiver &arc)
 {
    str name;
-   int num;
    int i;
 
    name = getName();
@@ -907,194 +1478,709 @@ EXPORT_FROM_DLL void Event::Archive(Archiver &arc)
    arc.WriteRaw(&info, sizeof(info));
    arc.WriteInteger(threadnum);
 
-   if(!data)
+   // Arguments are always saved in their text form so that savegames
+   // don't depend on how the event stores them.
+   arc.WriteInteger(numargs);
+   for(i = 0; i < numargs; i++)
    {
-      arc.WriteInteger(0);
+      name = ArgText(&args[i]);
+      arc.WriteString(name);
    }
-   else
+}
+
+EXPORT_FROM_DLL void Event::Unarchive(Archiver &arc)
+{
+   Event ev;
+   str name;
+   int i;
+   int num;
+
+   ClearArgs();
+
+   arc.ReadString(&name);
+   *this = Event(name);
+
+   arc.ReadRaw(&info, sizeof(info));
+   arc.ReadInteger(&threadnum);
+
+   arc.ReadInteger(&num);
+   for(i = 1; i <= num; i++)
+   {
+      arc.ReadString(&name);
+      AddString(name);
+   }
+}
+
+CLASS_DECLARATION(Class, Listener, NULL);
+
+ResponseDef Listener::Responses[] =
+{
+   { &EV_Remove,				(Response)&Listener::Remove },
+   { &EV_ScriptRemove,		(Response)&Listener::ScriptRemove },
+   { NULL, NULL }
+};
+
+EXPORT_FROM_DLL void Listener::Remove(Event *e)
+{
+   this->CancelPendingEvents();
+   delete this;
+}
+
+EXPORT_FROM_DLL void Listener::ScriptRemove(Event *e)
+{
+   // Forces the remove to be done at a safe time
+   PostEvent(EV_Remove, 0);
+}
+
+#if 0
+EXPORT_FROM_DLL void Listener::FloatVar(Event &e, float *var, float defaultvalue)
+{
+}
+
+EXPORT_FROM_DLL void Listener::IntVar(Event &e, int *var, float defaultvalue)
+{
+}
+
+EXPORT_FROM_DLL void Listener::StringVar(Event &e, str *var, const char *defaultvalue)
+{
+}
+
+EXPORT_FROM_DLL void Listener::StringVar(Event &e, char **var, const char *defaultvalue)
+{
+}
+
+EXPORT_FROM_DLL void Listener::VectorVar(Event &e, Vector *var, Vector defaultvalue)
+{
+}
+#endif
+
+EXPORT_FROM_DLL qboolean Listener::ValidEvent(Event &e)
+{
+   int             ev = (int)e;
+   const ClassDef *c  = this->classinfo();
+
+   assert((ev >= 0) && (ev < c->numEvents));
+   if((ev < 0) || (ev >= c->numEvents))
+   {
+      warning("ValidEvent", "Event '%s' out of response range for class '%s'.  "
+              "Event probably invalid or allocated late.\n", e.getName().c_str(), getClassname());
+      return false;
+   }
+
+   return (c->GetResponse(ev) != nullptr);
+}
+
+EXPORT_FROM_DLL qboolean Listener::ValidEvent(const char *name)
+{
+   int             ev = Event::FindEvent(name);
+   const ClassDef *c  = this->classinfo();
+
+   assert((ev >= 0) && (ev < c->numEvents));
+   if((ev < 0) || (ev >= c->numEvents))
+   {
+      warning("ValidEvent", "Event '%s' out of response range for class '%s'.  "
+              "Event probably invalid or allocated late.\n", name, getClassname());
+      return false;
+   }
+
+   return (c->GetResponse(ev) != nullptr);
+}
+
+static inline qboolean EventBefore(const eventcache_t *a, const eventcache_t *b)
+{
+   if(a->time != b->time)
+   {
+      return a->time < b->time;
+   }
+
+   return a->sequence < b->sequence;
+}
+
+static inline void EventHeapSet(int index, eventcache_t *event)
+{
+   EventHeap[index] = event;
+   event->heapindex = index;
+}
+
+static void EventHeapUp(int index)
+{
+   eventcache_t *event;
+   int parent;
+
+   event = EventHeap[index];
+   while(index > 0)
+   {
+      parent = (index - 1) >> 1;
+      if(!EventBefore(event, EventHeap[parent]))
+      {
+         break;
+      }
+
+      EventHeapSet(index, EventHeap[parent]);
+      index = parent;
+   }
+
+   EventHeapSet(index, event);
+}
+
+static void EventHeapDown(int index)
+{
+   eventcache_t *event;
+   int child;
+
+   event = EventHeap[index];
+   for(;;)
+   {
+      child = (index << 1) + 1;
+      if(child >= numEvents)
+      {
+         break;
+      }
+
+      if((child + 1 < numEvents) && EventBefore(EventHeap[child + 1], EventHeap[child]))
+      {
+         child++;
+      }
+
+      if(!EventBefore(EventHeap[child], event))
+      {
+         break;
+      }
+
+      EventHeapSet(index, EventHeap[child]);
+      index = child;
+   }
+
+   EventHeapSet(index, event);
+}
+
+static int CompareEventOrder(const void *arg1, const void *arg2)
+{
+   const eventcache_t *a = *(const eventcache_t **)arg1;
+   const eventcache_t *b = *(const eventcache_t **)arg2;
+
+   if(EventBefore(a, b))
+   {
+      return -1;
+   }
+
+   if(EventBefore(b, a))
+   {
+      return 1;
+   }
+
+   return 0;
+}
+
+//
+// Sorts the heap into dispatch order.  A sorted array is still a valid heap,
+// so this can be done at any time.  Also renumbers the sequence numbers from
+// zero so that the counter can wrap around safely.
+//
+static void SortEventHeap(void)
+{
+   int i;
+
+   qsort(EventHeap, numEvents, sizeof(EventHeap[0]), CompareEventOrder);
+
+   for(i = 0; i < numEvents; i++)
+   {
+      EventHeap[i]->heapindex = i;
+      EventHeap[i]->sequence = i;
+   }
+
+   eventSequence = numEvents;
+}
+
+static void EventHeapInsert(eventcache_t *event)
+{
+   if(eventSequence == 0xffffffff)
+   {
+      SortEventHeap();
+   }
+
+   event->sequence = eventSequence++;
+   EventHeapSet(numEvents++, event);
+   EventHeapUp(numEvents - 1);
+}
+
+static void EventHeapRemove(eventcache_t *event)
+{
+   eventcache_t *moved;
+   int index;
+
+   index = event->heapindex;
+   assert((index >= 0) && (index < numEvents) && (EventHeap[index] == event));
+
+   numEvents--;
+   if(index < numEvents)
+   {
+      moved = EventHeap[numEvents];
+      EventHeapSet(index, moved);
+      EventHeapUp(index);
+      if(moved->heapindex == index)
+      {
+         EventHeapDown(index);
+      }
+   }
+
+   event->heapindex = -1;
+}
+
+//
+// Adds an event to the queue and to its object's list of pending events
+//
+static void QueueEvent(eventcache_t *event)
+{
+   EventHeapInsert(event);
+   event->LinkToObject();
+}
+
+static void DequeueEvent(eventcache_t *event)
+{
+   EventHeapRemove(event);
+   event->UnlinkFromObject();
+}
+
+//
+// Removes all the events pending on obj and frees them.  An eventnum of -1 
+// matches any event.
+//
+static void CancelMatchingEvents(Listener *obj, int eventnum)
+{
+   eventcache_t *event;
+   eventcache_t *next;
+
+   for(event = eventcache_t::FirstOnObject(obj); event != NULL; event = next)
+   {
+      next = event->objnext;
+      if((eventnum < 0) || ((int)*event->event == eventnum))
+      {
+         DequeueEvent(event);
+         delete event->event;
+         event->event = NULL;
+         LL_Add(FreeEvents, event, next, prev);
+      }
+   }
+}
+
+//
+// Returns the first event in dispatch order that is pending on obj.  An 
+// eventnum of -1 matches any event.
+//
+static eventcache_t *FindFirstEvent(Listener *obj, int eventnum)
+{
+   eventcache_t *event;
+   eventcache_t *best;
+
+   best = NULL;
+   for(event = eventcache_t::FirstOnObject(obj); event != NULL; event = event->objnext)
+   {
+      if((eventnum < 0) || ((int)*event->event == eventnum))
+      {
+         if(!best || EventBefore(event, best))
+         {
+            best = event;
+         }
+      }
+   }
+
+   return best;
+}
+
+EXPORT_FROM_DLL qboolean Listener::EventPending(Event &ev)
+{
+   eventcache_t *event;
+   int eventnum;
+
+   eventnum = (int)ev;
+   for(event = pendingEvents; event != NULL; event = event->objnext)
+   {
+      if((int)*event->event == eventnum)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+EXPORT_FROM_DLL inline qboolean Listener::CheckEventFlags(Event *event)
+{
+   // Special handling of console events
+   if(event->GetSource() == EV_FROM_CONSOLE)
+   {
+      if(!(event->info.flags & (EV_CONSOLE | EV_CHEAT)))
+      {
+         if(isSubclassOf<Entity>())
+         {
+            Entity *ent;
+
+            ent = static_cast<Entity *>(this);
+            gi.cprintf(ent->edict, PRINT_HIGH, "Command not available from console.\n");
+         }
+
+         // don't process
+         return false;
+      }
+
+      // don't allow console cheats during deathmatch unless the server says it's ok.
+      if((event->info.flags & EV_CHEAT) && deathmatch->value && !sv_cheats->value)
+      {
+         if(isSubclassOf<Entity>())
+         {
+            Entity *ent;
+
+            ent = static_cast<Entity *>(this);
+            gi.cprintf(ent->edict, PRINT_HIGH, "You must run the server with '+set cheats 1' to enable this command.\n");
+         }
+
+         // don't process
+         return false;
+      }
+   }
+
+   // ok to process
+   return true;
+}
+
+/*
+===============================================================================
+
+Event profiler
+
+When g_profileevents is set, every event that's dispatched is timed and the 
+time is added up by event and by the class that handled it.  Total time 
+includes any events the handler dispatched itself, self time doesn't.  The 
+queue depth and the number of events run each frame are tracked as well, 
+along with frames that came close to (or hit) g_eventlimit.
+
+  sv eventprof [top [count] [events|classes]]
+  sv eventprof csv <filename>
+  sv eventprof reset
+
+===============================================================================
+*/
+
+// a frame that runs more than this fraction of g_eventlimit is a near miss
+#define EVENT_NEARMISS_FRACTION  0.75f
+
+typedef struct
+{
+   int      count;
+   double   total;   // microseconds
+   double   self;    // microseconds
+   unsigned max;     // microseconds
+} eventprofile_t;
+
+static eventprofile_t *eventProfile = nullptr;   // by event number
+static int             numEventProfile = 0;
+static eventprofile_t *classProfile = nullptr;   // by ClassDef::treePre
+static int             numClassProfile = 0;
+
+// time spent in events dispatched by the handler that's running
+static unsigned        profileChildTime = 0;
+
+static int             profileFrames = 0;
+static double          profileQueueTotal = 0;
+static int             profileMaxQueue = 0;
+static int             profileMaxDispatched = 0;
+static int             profileNearMisses = 0;
+static int             profileOverflows = 0;
+
+static void AddProfileTime(eventprofile_t *p, unsigned elapsed, unsigned self)
+{
+   p->count++;
+   p->total += elapsed;
+   p->self += self;
+   if(elapsed > p->max)
+   {
+      p->max = elapsed;
+   }
+}
+
+static void ProfileEvent(int ev, const ClassDef *cls, unsigned elapsed, unsigned self)
+{
+   const ClassDef *list;
+   const ClassDef *c;
+
+   if(!eventProfile)
    {
-      num = data->NumObjects();
+      numEventProfile = Event::NumEventCommands();
+      eventProfile = new eventprofile_t[numEventProfile];
+      memset(eventProfile, 0, sizeof(eventprofile_t) * numEventProfile);
+   }
 
-      arc.WriteInteger(num);
-      for(i = 1; i <= num; i++)
+   if(!classProfile)
+   {
+      list = getClassList();
+      for(c = list->next; c != list; c = c->next)
       {
-         arc.WriteString(data->ObjectAt(i));
+         if(c->treePre >= numClassProfile)
+         {
+            numClassProfile = c->treePre + 1;
+         }
       }
+
+      classProfile = new eventprofile_t[numClassProfile];
+      memset(classProfile, 0, sizeof(eventprofile_t) * numClassProfile);
+   }
+
+   if(ev < numEventProfile)
+   {
+      AddProfileTime(&eventProfile[ev], elapsed, self);
+   }
+
+   if(cls->treePre < numClassProfile)
+   {
+      AddProfileTime(&classProfile[cls->treePre], elapsed, self);
    }
 }
 
-EXPORT_FROM_DLL void Event::Unarchive(Archiver &arc)
+static void ProfileEventFrame(int queued, int dispatched, int maxevents)
 {
-   Event ev;
-   str name;
-   int i;
-   int num;
-
-   if(data)
+   profileFrames++;
+   profileQueueTotal += queued;
+   if(queued > profileMaxQueue)
    {
-      delete data;
-      data = NULL;
+      profileMaxQueue = queued;
    }
 
-   arc.ReadString(&name);
-   *this = Event(name);
-
-   arc.ReadRaw(&info, sizeof(info));
-   arc.ReadInteger(&threadnum);
+   if(dispatched > profileMaxDispatched)
+   {
+      profileMaxDispatched = dispatched;
+   }
 
-   arc.ReadInteger(&num);
-   if(num)
+   if(dispatched > maxevents)
    {
-      data = new Container<str>();
-      data->Resize(num);
-      for(i = 1; i <= num; i++)
-      {
-         arc.ReadString(&name);
-         data->AddObject(name);
-      }
+      profileOverflows++;
+   }
+   else if(dispatched > maxevents * EVENT_NEARMISS_FRACTION)
+   {
+      profileNearMisses++;
    }
 }
 
-CLASS_DECLARATION(Class, Listener, NULL);
-
-ResponseDef Listener::Responses[] =
-{
-   { &EV_Remove,				(Response)&Listener::Remove },
-   { &EV_ScriptRemove,		(Response)&Listener::ScriptRemove },
-   { NULL, NULL }
-};
-
-EXPORT_FROM_DLL void Listener::Remove(Event *e)
+static void ResetEventProfile(void)
 {
-   this->CancelPendingEvents();
-   delete this;
-}
+   if(eventProfile)
+   {
+      delete [] eventProfile;
+      eventProfile = nullptr;
+   }
+   numEventProfile = 0;
 
-EXPORT_FROM_DLL void Listener::ScriptRemove(Event *e)
-{
-   // Forces the remove to be done at a safe time
-   PostEvent(EV_Remove, 0);
-}
+   if(classProfile)
+   {
+      delete [] classProfile;
+      classProfile = nullptr;
+   }
+   numClassProfile = 0;
 
-#if 0
-EXPORT_FROM_DLL void Listener::FloatVar(Event &e, float *var, float defaultvalue)
-{
+   profileFrames = 0;
+   profileQueueTotal = 0;
+   profileMaxQueue = 0;
+   profileMaxDispatched = 0;
+   profileNearMisses = 0;
+   profileOverflows = 0;
 }
 
-EXPORT_FROM_DLL void Listener::IntVar(Event &e, int *var, float defaultvalue)
+typedef struct
 {
-}
+   const char           *name;
+   const eventprofile_t *profile;
+} eventprofileentry_t;
 
-EXPORT_FROM_DLL void Listener::StringVar(Event &e, str *var, const char *defaultvalue)
+static int compareProfileEntries(const void *arg1, const void *arg2)
 {
-}
+   const eventprofile_t *p1 = ((const eventprofileentry_t *)arg1)->profile;
+   const eventprofile_t *p2 = ((const eventprofileentry_t *)arg2)->profile;
 
-EXPORT_FROM_DLL void Listener::StringVar(Event &e, char **var, const char *defaultvalue)
-{
-}
+   // most time first
+   if(p1->self != p2->self)
+   {
+      return (p1->self < p2->self) ? 1 : -1;
+   }
 
-EXPORT_FROM_DLL void Listener::VectorVar(Event &e, Vector *var, Vector defaultvalue)
-{
+   return p2->count - p1->count;
 }
-#endif
 
-EXPORT_FROM_DLL qboolean Listener::ValidEvent(Event &e)
+//
+// Gathers up everything that was profiled, sorted by self time.  Returns the 
+// number of entries.
+//
+static int GetProfileEntries(qboolean classes, eventprofileentry_t **entries)
 {
-   int             ev = (int)e;
-   const ClassDef *c  = this->classinfo();
+   const ClassDef      *list;
+   const ClassDef      *c;
+   eventprofileentry_t *e;
+   int                  num;
+   int                  i;
 
-   assert((ev >= 0) && (ev < c->numEvents));
-   if((ev < 0) || (ev >= c->numEvents))
+   num = 0;
+   if(!classes)
    {
-      warning("ValidEvent", "Event '%s' out of response range for class '%s'.  "
-              "Event probably invalid or allocated late.\n", e.getName().c_str(), getClassname());
-      return false;
+      e = new eventprofileentry_t[numEventProfile + 1];
+      for(i = 1; i < numEventProfile; i++)
+      {
+         if(eventProfile[i].count)
+         {
+            e[num].name = Event::GetEventName(i);
+            e[num].profile = &eventProfile[i];
+            num++;
+         }
+      }
+   }
+   else
+   {
+      e = new eventprofileentry_t[numClassProfile + 1];
+      list = getClassList();
+      for(c = list->next; c != list; c = c->next)
+      {
+         if((c->treePre < numClassProfile) && classProfile[c->treePre].count)
+         {
+            e[num].name = c->classname;
+            e[num].profile = &classProfile[c->treePre];
+            num++;
+         }
+      }
    }
 
-   return (c->responseLookup[ev] != nullptr);
+   qsort(e, num, sizeof(eventprofileentry_t), compareProfileEntries);
+
+   *entries = e;
+   return num;
 }
 
-EXPORT_FROM_DLL qboolean Listener::ValidEvent(const char *name)
+static void PrintEventProfile(qboolean classes, int count)
 {
-   int             ev = Event::FindEvent(name);
-   const ClassDef *c  = this->classinfo();
+   eventprofileentry_t  *entries;
+   const eventprofile_t *p;
+   int                   num;
+   int                   i;
 
-   assert((ev >= 0) && (ev < c->numEvents));
-   if((ev < 0) || (ev >= c->numEvents))
+   num = GetProfileEntries(classes, &entries);
+   if(count > num)
    {
-      warning("ValidEvent", "Event '%s' out of response range for class '%s'.  "
-              "Event probably invalid or allocated late.\n", name, getClassname());
-      return false;
+      count = num;
+   }
+
+   gi.printf("%-32s %8s %10s %10s %8s %8s\n", classes ? "class" : "event", "count", "total ms", "self ms", "avg us", "max us");
+   gi.printf("-------------------------------- -------- ---------- ---------- -------- --------\n");
+   for(i = 0; i < count; i++)
+   {
+      p = entries[i].profile;
+      gi.printf("%-32s %8d %10.2f %10.2f %8.1f %8u\n", entries[i].name, p->count, p->total / 1000.0,
+                p->self / 1000.0, p->total / p->count, p->max);
    }
 
-   return (c->responseLookup[ev] != nullptr);
+   delete [] entries;
 }
 
-EXPORT_FROM_DLL qboolean Listener::EventPending(Event &ev)
+static void WriteEventProfile(const char *filename)
 {
-   eventcache_t *event;
-   int eventnum;
+   FILE                 *f;
+   char                  name[MAX_OSPATH];
+   eventprofileentry_t  *entries;
+   const eventprofile_t *p;
+   cvar_t               *game;
+   int                   num;
+   int                   i;
+   int                   type;
+
+   game = gi.cvar("game", "", 0);
+
+   if(!*game->string)
+   {
+      snprintf(name, sizeof(name), "%s/%s", GAMEVERSION, filename);
+   }
+   else
+   {
+      snprintf(name, sizeof(name), "%s/%s", game->string, filename);
+   }
 
-   assert(EventQueue);
-   assert(EventQueue->next);
+   gi.printf("Writing %s.\n", name);
 
-   event = EventQueue->next;
+   f = fopen(name, "wt");
+   if(!f)
+   {
+      gi.printf("Couldn't open %s\n", name);
+      return;
+   }
 
-   eventnum = (int)ev;
-   while(event != EventQueue)
+   fprintf(f, "type,name,count,total_us,self_us,max_us\n");
+   for(type = 0; type < 2; type++)
    {
-      if((event->obj == this) && ((int)*event->event == eventnum))
+      num = GetProfileEntries(type, &entries);
+      for(i = 0; i < num; i++)
       {
-         return true;
+         p = entries[i].profile;
+         fprintf(f, "%s,%s,%d,%.0f,%.0f,%u\n", type ? "class" : "event", entries[i].name, p->count, p->total, p->self, p->max);
       }
-      event = event->next;
+      delete [] entries;
    }
 
-   return false;
+   fclose(f);
 }
 
-EXPORT_FROM_DLL inline qboolean Listener::CheckEventFlags(Event *event)
+EXPORT_FROM_DLL void G_EventProfileCommand(void)
 {
-   // Special handling of console events
-   if(event->GetSource() == EV_FROM_CONSOLE)
-   {
-      if(!(event->info.flags & (EV_CONSOLE | EV_CHEAT)))
-      {
-         if(isSubclassOf<Entity>())
-         {
-            Entity *ent;
+   const char *cmd;
+   int         count;
+   qboolean    classes;
+   int         i;
 
-            ent = static_cast<Entity *>(this);
-            gi.cprintf(ent->edict, PRINT_HIGH, "Command not available from console.\n");
-         }
+   cmd = gi.argv(2);
+   if(!Q_stricmp(cmd, "reset"))
+   {
+      ResetEventProfile();
+      return;
+   }
 
-         // don't process
-         return false;
-      }
+   if(!eventProfile)
+   {
+      gi.printf("No events profiled.  Set g_profileevents to 1 to start.\n");
+      return;
+   }
 
-      // don't allow console cheats during deathmatch unless the server says it's ok.
-      if((event->info.flags & EV_CHEAT) && deathmatch->value && !sv_cheats->value)
+   if(!Q_stricmp(cmd, "csv"))
+   {
+      if(gi.argc() < 4)
       {
-         if(isSubclassOf<Entity>())
-         {
-            Entity *ent;
+         gi.printf("Usage: sv eventprof csv <filename>\n");
+         return;
+      }
 
-            ent = static_cast<Entity *>(this);
-            gi.cprintf(ent->edict, PRINT_HIGH, "You must run the server with '+set cheats 1' to enable this command.\n");
-         }
+      WriteEventProfile(gi.argv(3));
+      return;
+   }
 
-         // don't process
-         return false;
+   // top [count] [events|classes]
+   count = 20;
+   classes = false;
+   for(i = 3; i < gi.argc(); i++)
+   {
+      if(!Q_stricmp(gi.argv(i), "classes"))
+      {
+         classes = true;
+      }
+      else if(atoi(gi.argv(i)) > 0)
+      {
+         count = atoi(gi.argv(i));
       }
    }
 
-   // ok to process
-   return true;
+   PrintEventProfile(classes, count);
+
+   gi.printf("\n%d frames, queue depth %.1f avg %d max, %d events max in a frame\n", profileFrames,
+             profileFrames ? profileQueueTotal / profileFrames : 0.0, profileMaxQueue, profileMaxDispatched);
+   gi.printf("%d frames near g_eventlimit, %d over it\n", profileNearMisses, profileOverflows);
 }
 
 EXPORT_FROM_DLL qboolean Listener::ProcessEvent(Event *event)
 {
    const ClassDef *c;
+   Response       *response;
    int             ev;
    int             i;
 
@@ -1174,20 +2260,41 @@ EXPORT_FROM_DLL qboolean Listener::ProcessEvent(Event *event)
       return false;
    }
 
-   if(c->responseLookup[ev])
+   response = c->GetResponse(ev);
+   if(response)
    {
       int start;
       int end;
 
       event->info.inuse++;
+      eventsDispatched++;
 
-      if(!g_timeevents->value)
+      if(!g_timeevents->value && !g_profileevents->value)
+      {
+         // only process the event if we allow it
+         if(CheckEventFlags(event))
+         {
+            (this->**response)(event);
+         }
+      }
+      else if(g_profileevents->value)
       {
+         unsigned parenttime;
+         unsigned elapsed;
+
+         parenttime = profileChildTime;
+         profileChildTime = 0;
+         elapsed = G_Microseconds();
+
          // only process the event if we allow it
          if(CheckEventFlags(event))
          {
-            (this->**c->responseLookup[ev])(event);
+            (this->**response)(event);
          }
+
+         elapsed = G_Microseconds() - elapsed;
+         ProfileEvent(ev, c, elapsed, elapsed - profileChildTime);
+         profileChildTime = parenttime + elapsed;
       }
       else
       {
@@ -1196,7 +2303,7 @@ EXPORT_FROM_DLL qboolean Listener::ProcessEvent(Event *event)
          // only process the event if we allow it
          if(CheckEventFlags(event))
          {
-            (this->**c->responseLookup[ev])(event);
+            (this->**response)(event);
          }
 
          end = G_Milliseconds();
@@ -1231,7 +2338,6 @@ EXPORT_FROM_DLL qboolean Listener::ProcessEvent(Event *event)
 EXPORT_FROM_DLL void Listener::PostEvent(Event *ev, float time)
 {
    eventcache_t *newevent;
-   eventcache_t *event;
 
    if(LoadingSavegame)
    {
@@ -1265,101 +2371,36 @@ EXPORT_FROM_DLL void Listener::PostEvent(Event *ev, float time)
    newevent->event = ev;
    newevent->time = level.time + time;
 
-   event = EventQueue->next;
-   while((event != EventQueue) && (newevent->time >= event->time))
-   {
-      event = event->next;
-   }
-
-   LL_Add(event, newevent, next, prev);
-   numEvents++;
+   QueueEvent(newevent);
 }
 
 EXPORT_FROM_DLL qboolean Listener::PostponeEvent(Event &ev, float time)
 {
    eventcache_t *event;
-   eventcache_t *node;
-   int eventnum;
-
-   assert(EventQueue);
-   assert(EventQueue->next);
-
-   eventnum = (int)ev;
 
-   event = EventQueue->next;
-   while(event != EventQueue)
+   event = FindFirstEvent(this, (int)ev);
+   if(!event)
    {
-      if((event->obj == this) && ((int)*event->event == eventnum))
-      {
-         event->time += time;
-
-         node = event->next;
-         while((node != EventQueue) && (event->time >= node->time))
-         {
-            node = node->next;
-         }
-
-         LL_Remove(event, next, prev);
-         LL_Add(node, event, next, prev);
-
-         return true;
-      }
-      event = event->next;
+      return false;
    }
 
-   return false;
+   // Re-insert it as if it had just been posted, so that it goes after any
+   // events that are already waiting for the same time.
+   EventHeapRemove(event);
+   event->time += time;
+   EventHeapInsert(event);
+
+   return true;
 }
 
 EXPORT_FROM_DLL void Listener::CancelEventsOfType(Event *ev)
 {
-   eventcache_t *event;
-   eventcache_t *next;
-   int eventnum;
-
-   assert(EventQueue);
-   assert(EventQueue->next);
-
-   event = EventQueue->next;
-
-   eventnum = (int)*ev;
-   while(event != EventQueue)
-   {
-      next = event->next;
-      if((event->obj == this) && ((int)*event->event == eventnum))
-      {
-         delete event->event;
-         event->event = NULL;
-         LL_Remove(event, next, prev);
-         LL_Add(FreeEvents, event, next, prev);
-         numEvents--;
-      }
-      event = next;
-   }
+   CancelMatchingEvents(this, (int)*ev);
 }
 
 EXPORT_FROM_DLL void Listener::CancelPendingEvents(void)
 {
-   eventcache_t *event;
-   eventcache_t *next;
-
-   assert(EventQueue);
-   assert(EventQueue->next);
-
-   event = EventQueue->next;
-
-   while(event != EventQueue)
-   {
-      next = event->next;
-      if(event->obj == this)
-      {
-         delete event->event;
-         event->event = NULL;
-         LL_Remove(event, next, prev);
-         LL_Add(FreeEvents, event, next, prev);
-         numEvents--;
-      }
-      event = next;
-   }
+   CancelMatchingEvents(this, -1);
 }
 
 EXPORT_FROM_DLL qboolean Listener::ProcessPendingEvents(void)
@@ -1368,51 +2409,27 @@ EXPORT_FROM_DLL qboolean Listener::ProcessPendingEvents(void)
    qboolean processedEvents;
    float t;
 
-   assert(EventQueue);
-   assert(EventQueue->next);
-   assert(EventQueue->prev);
-
    processedEvents = false;
 
    t = level.time + 0.001;
 
-   event = EventQueue->next;
-   while(event != EventQueue)
+   // look for the next event each time through, since can't guarantee that 
+   // processing an event didn't post or cancel any others
+   while((event = FindFirstEvent(this, -1)) && (event->time <= t))
    {
-      assert(event);
       assert(event->event);
-      assert(event->obj);
-
-      if(event->time > t)
-      {
-         break;
-      }
-
-      if(event->obj != this)
-      {
-         // traverse normally
-         event = event->next;
-      }
-      else
-      {
-         LL_Remove(event, next, prev);
-         numEvents--;
-
-         assert(event->obj);
 
-         // ProcessEvent increments the inuse count, so decrement it since we've already incremented it in PostEvent
-         event->event->info.inuse--;
+      DequeueEvent(event);
 
-         event->obj->ProcessEvent(event->event);
+      // ProcessEvent increments the inuse count, so decrement it since we've already incremented it in PostEvent
+      event->event->info.inuse--;
 
-         event->event = NULL;
-         LL_Add(FreeEvents, event, next, prev);
+      event->obj->ProcessEvent(event->event);
 
-         // start over, since can't guarantee that we didn't process any previous or following events
-         event = EventQueue->next;
+      event->event = NULL;
+      LL_Add(FreeEvents, event, next, prev);
 
-         processedEvents = true;
-      }
+      processedEvents = true;
    }
 
    return processedEvents;
@@ -1428,16 +2445,26 @@ EXPORT_FROM_DLL void G_ClearEventList(void)
    int i;
    eventcache_t *e;
 
+   // anything still waiting on an event is about to lose it
+   for(i = 0; i < numEvents; i++)
+   {
+      if(EventHeap[i]->obj)
+      {
+         eventcache_t::ClearObject(EventHeap[i]->obj);
+      }
+   }
+
    LL_Reset(FreeEvents, next, prev);
-   LL_Reset(EventQueue, next, prev);
    memset(Events, 0, sizeof(Events));
 
    for(e = &Events[0], i = 0; i < MAX_EVENTS; i++, e++)
    {
+      e->heapindex = -1;
       LL_Add(FreeEvents, e, next, prev);
    }
 
    numEvents = 0;
+   eventSequence = 0;
 }
 
 EXPORT_FROM_DLL void G_ProcessPendingEvents(void)
@@ -1446,18 +2473,16 @@ EXPORT_FROM_DLL void G_ProcessPendingEvents(void)
    float t;
    int num;
    int maxevents;
-
-   assert(EventQueue);
-   assert(EventQueue->next);
-   assert(EventQueue->prev);
+   int queued;
 
    maxevents = (int)g_eventlimit->value;
+   queued = numEvents;
 
    num = 0;
    t = level.time + 0.001;
-   while(!LL_Empty(EventQueue, next, prev))
+   while(numEvents)
    {
-      event = EventQueue->next;
+      event = EventHeap[0];
 
       assert(event);
       assert(event->event);
@@ -1468,10 +2493,7 @@ EXPORT_FROM_DLL void G_ProcessPendingEvents(void)
          break;
       }
 
-      LL_Remove(event, next, prev);
-      numEvents--;
-
-      assert(event->obj);
+      DequeueEvent(event);
 
       // ProcessEvent increments the inuse count, so decrement it since we've already incremented it in PostEvent
       assert(event->event->info.inuse > 0);
@@ -1492,20 +2514,27 @@ EXPORT_FROM_DLL void G_ProcessPendingEvents(void)
          break;
       }
    }
+
+   if(g_profileevents->value)
+   {
+      ProfileEventFrame(queued, num, maxevents);
+   }
 }
 
 EXPORT_FROM_DLL void G_ArchiveEvents(Archiver &arc)
 {
    eventcache_t *event;
    int num;
+   int i;
 
-   assert(EventQueue);
-   assert(EventQueue->next);
-   assert(EventQueue->prev);
+   // Events are written out in the order they'll be dispatched in
+   SortEventHeap();
 
    num = 0;
-   for(event = EventQueue->next; event != EventQueue; event = event->next)
+   for(i = 0; i < numEvents; i++)
    {
+      event = EventHeap[i];
+
       assert(event);
       assert(event->event);
       assert(event->obj);
@@ -1520,11 +2549,9 @@ EXPORT_FROM_DLL void G_ArchiveEvents(Archiver &arc)
    }
 
    arc.WriteInteger(num);
-   for(event = EventQueue->next; event != EventQueue; event = event->next)
+   for(i = 0; i < numEvents; i++)
    {
-      assert(event);
-      assert(event->event);
-      assert(event->obj);
+      event = EventHeap[i];
 
       if(event->obj->isSubclassOf<Entity>() &&
          (((Entity *)event->obj)->flags & FL_DONTSAVE))
@@ -1542,41 +2569,64 @@ EXPORT_FROM_DLL void G_UnarchiveEvents(Archiver &arc)
 {
    eventcache_t *e;
    int i;
+   int num;
 
-   LL_Reset(FreeEvents, next, prev);
-   LL_Reset(EventQueue, next, prev);
-   memset(Events, 0, sizeof(Events));
+   G_ClearEventList();
 
-   arc.ReadInteger(&numEvents);
-   for(e = &Events[0], i = 0; i < numEvents; i++, e++)
+   arc.ReadInteger(&num);
+   for(i = 0; i < num; i++)
    {
+      e = FreeEvents->next;
+      LL_Remove(e, next, prev);
+
       arc.ReadObjectPointer((Class **)&e->obj);
       e->event = new Event();
       arc.ReadEvent(e->event);
       arc.ReadFloat(&e->time);
 
-      LL_Add(EventQueue, e, next, prev);
+      // events were saved in dispatch order, so sequence numbers carry on from here.
+      // The object pointers aren't valid until the archive is closed, so linking 
+      // them to their objects waits until G_LinkUnarchivedEvents.
+      EventHeapInsert(e);
    }
+}
+
+//
+// Called once the savegame has been read in and all the pointers have been
+// fixed up.
+//
+EXPORT_FROM_DLL void G_LinkUnarchivedEvents(void)
+{
+   int i;
 
-   for(; i < MAX_EVENTS; i++, e++)
+   for(i = 0; i < numEvents; i++)
    {
-      LL_Add(FreeEvents, e, next, prev);
+      assert(EventHeap[i]->obj);
+      EventHeap[i]->LinkToObject();
    }
 }
 
 EXPORT_FROM_DLL void G_InitEvents(void)
 {
+   unsigned start;
+
+   Event::ClassInfo.slab = &EventSlab;
+
    g_numevents  = gi.cvar("g_numevents",  "0",    0);
    g_showevents = gi.cvar("g_showevents", "0",    0);
    g_eventlimit = gi.cvar("g_eventlimit", "1500", 0);
    g_timeevents = gi.cvar("g_timeevents", "0",    0);
+   g_profileevents = gi.cvar("g_profileevents", "0", 0);
    g_watch      = gi.cvar("g_watch",      "0",    0);
 
+   start = G_Microseconds();
    BuildEventResponses();
+   start = G_Microseconds() - start;
+
    G_ClearEventList();
 
-   // Sort the list before we go on since we won't be adding any more events
-   Event::SortEventList();
+   gi.dprintf("%d events registered in %.2f ms (%d hash slots), responses built in %.2f ms\n",
+      Event::NumEventCommands(), eventRegisterTime / 1000.0f, Event::hashSize, start / 1000.0f);
 }
 
 // EOF
@@ -37,8 +37,44 @@ typedef enum
 
 #define MAX_EVENT_USE ( ( 1 << 8 ) - 1 )
 
+// Event argument types.  Arguments added from code keep their native value
+// and only generate a text form when something asks for it.  String arguments
+// (which includes everything that comes from scripts and the console) are
+// parsed when they're read, same as always.
+typedef enum
+{
+   EVARG_STRING,
+   EVARG_INTEGER,
+   EVARG_FLOAT,
+   EVARG_VECTOR,
+   EVARG_ENTITY
+} eventargtype_t;
+
+// eventarg_t flags
+#define EVARG_HEAPTEXT  1 // text didn't fit in the event's text buffer and was allocated
+
+// Most events carry only a handful of arguments, so these are stored in the
+// event itself and only spill over to the heap when there are more.
+#define EVENT_INLINE_ARGS 6
+#define EVENT_INLINE_TEXT 48
+
+typedef struct
+{
+   unsigned char     type;
+   unsigned char     flags;
+   union
+   {
+      int            integer;
+      float          value;
+      float          vector[3];
+   };
+   const char       *text;
+} eventarg_t;
+
 class ScriptThread;
 class Archiver;
+struct eventcache_s;
+struct eventpayload_s;
 
 class Event : public Class
 {
@@ -54,11 +90,28 @@ private:
    int               eventnum  = 0;
    EventInfo         info;
    const char       *name      = nullptr;
-   Container<str>   *data      = nullptr;
+   eventarg_t       *args      = argbuf;
+   short             numargs   = 0;
+   short             maxargs   = EVENT_INLINE_ARGS;
+   int               textused  = 0;
    int               threadnum = -1;
+   eventpayload_s   *payload   = nullptr;    // shared arguments, see ShareArgs
+   eventarg_t        argbuf[EVENT_INLINE_ARGS];
+   char              textbuf[EVENT_INLINE_TEXT];
 
    static void       initCommandList();
 
+   eventarg_t       *NewArg(eventargtype_t type);
+   eventarg_t       *GetArg(int pos);
+   char             *AllocText(eventarg_t *arg, int size);
+   void              SetArgText(eventarg_t *arg, const char *text);
+   const char       *ArgText(eventarg_t *arg);
+   void              CopyArgs(const Event &ev);
+   void              CopyArgArray(const eventarg_t *src, int num);
+   void              UnshareArgs();
+   void              FreeArgArray();
+   void              ClearArgs();
+
    friend class Listener;
 
    friend void G_ProcessPendingEvents();
@@ -69,11 +122,12 @@ private:
 
    static Container<str *> *commandList;
    static Container<int>   *flagList;
-   static Container<int>   *sortedList;
-   static qboolean          dirtylist;
+   static int              *hashTable;
+   static int               hashSize;
 
    static int			compareEvents(const void *arg1, const void *arg2);
-   static void			SortEventList();
+   static void			AddToHash(int eventnum);
+   static int			RegisterEvent(const char *name, int flags);
    static int			FindEvent(const char *name);
    static int			FindEvent(str &name);
 
@@ -81,6 +135,8 @@ public:
    CLASS_PROTOTYPE(Event);
 
    static int        NumEventCommands();
+   static const char *GetEventName(int eventnum);
+   static int        GetEventNum(const char *command);
    static void       ListCommands(const char *mask = nullptr);
 
    Event();
@@ -91,6 +147,8 @@ public:
    Event(str &command, int flags = -1);
    ~Event();
 
+   Event            &operator = (const Event &ev);
+
    str               getName() const;
 
    void              SetSource(eventsource_t source);
@@ -139,6 +197,8 @@ public:
    void              AddVector(Vector &vec);
    void              AddEntity(Entity *ent);
 
+   void              ShareArgs();
+
    virtual void      Archive(Archiver &arc)   override;
    virtual void      Unarchive(Archiver &arc) override;
 };
@@ -149,6 +209,10 @@ extern Event EV_Remove;
 class Listener : public Class
 {
 private:
+   // events that have been posted to this listener, linked through eventcache_s::objnext
+   struct eventcache_s    *pendingEvents = nullptr;
+   friend struct eventcache_s;
+
    void                    FloatVarEvent(Event *e);
    void                    IntVarEvent(Event *e);
    void                    StringVarEvent(Event *e);
@@ -185,6 +249,13 @@ public:
    qboolean	               ProcessPendingEvents();
 };
 
+void G_LinkUnarchivedEvents();
+void G_PrintEventPoolStats();
+void G_EventProfileCommand();
+
+// number of events that have been handled, used by the script profiler
+extern unsigned eventsDispatched;
+
 inline qboolean Event::Exists(const char *command)
 {
    int num;
@@ -206,6 +277,16 @@ inline qboolean Event::Exists(const char *command)
 }
 
 
+inline int Event::GetEventNum(const char *command)
+{
+   if(!commandList)
+   {
+      initCommandList();
+   }
+
+   return FindEvent(command);
+}
+
 inline Event Event::Find(const char *command)
 {
    int num;
@@ -322,12 +403,7 @@ inline Event::operator const char *() const
 
 inline int Event::NumArgs()
 {
-   if(!data)
-   {
-      return 0;
-   }
-
-   return (data->NumObjects());
+   return numargs;
 }
 
 inline void Event::AddToken(const char *text)
@@ -348,67 +424,50 @@ inline void Event::AddTokens(int argc, const char **argv)
 
 inline void Event::AddString(const char *text)
 {
-   if(!data)
-   {
-      data = new Container<str>();
-      data->Resize(1);
-   }
-
-   data->AddObject(str(text));
+   SetArgText(NewArg(EVARG_STRING), text);
 }
 
 inline void Event::AddString(str &text)
 {
-   if(!data)
-   {
-      data = new Container<str>();
-      data->Resize(1);
-   }
-
-   data->AddObject(text);
+   SetArgText(NewArg(EVARG_STRING), text.c_str());
 }
 
 inline void Event::AddInteger(int val)
 {
-   char text[128];
-
-   snprintf(text, sizeof(text), "%d", val);
-   AddString(text);
+   NewArg(EVARG_INTEGER)->integer = val;
 }
 
 inline void Event::AddDouble(double val)
 {
-   char text[128];
-
-   snprintf(text, sizeof(text), "%f", val);
-   AddString(text);
+   NewArg(EVARG_FLOAT)->value = (float)val;
 }
 
 inline void Event::AddFloat(float val)
 {
-   char text[128];
-
-   snprintf(text, sizeof(text), "%f", val);
-   AddString(text);
+   NewArg(EVARG_FLOAT)->value = val;
 }
 
 inline void Event::AddVector(Vector &vec)
 {
-   char text[128];
+   eventarg_t *arg;
 
-   snprintf(text, sizeof(text), "(%f %f %f)", vec[0], vec[1], vec[2]);
-   AddString(text);
+   arg = NewArg(EVARG_VECTOR);
+   arg->vector[0] = vec[0];
+   arg->vector[1] = vec[1];
+   arg->vector[2] = vec[2];
 }
 
 inline const char *Event::GetToken(int pos)
 {
-   if(!data || (pos < 1) || (data->NumObjects() < pos))
+   eventarg_t *arg;
+
+   arg = GetArg(pos);
+   if(!arg)
    {
-      Error("Index %d out of range.", pos);
       return "";
    }
 
-   return data->ObjectAt(pos).c_str();
+   return ArgText(arg);
 }
 
 inline qboolean Listener::ProcessEvent(Event &event)
@@ -78,6 +78,7 @@ void ManeroCopter::StartAttacking(Event *ev)
 
    // start doing the copters post thinking
    flags |= FL_POSTTHINK;
+   Wake();
 }
 
 // this disables the copters attack state
@@ -592,6 +593,7 @@ ManeroBoss::ManeroBoss() : Actor()
 
    dropweapon = false;
    flags |= FL_POSTTHINK;
+   Wake();
 
    // give Manero lotsa armor
    if(skill->value == 0)
@@ -773,7 +775,7 @@ void ManeroBoss::Pain(Event *ev)
    float oldhealth = (health + damage) / max_health;
    float newhealth = health / max_health;
 
-   SetVariable("other", ev->GetEntity(2));
+   SetVariable(otherVar, ev->GetEntity(2));
 
    // If we pass more than one range,  
    if((oldhealth > 0.875) && (newhealth <= 0.875))
@@ -858,7 +860,7 @@ void ManeroBoss::Killed(Event *ev)
    Entity *inflictor    = ev->GetEntity(3);
    int     meansofdeath = ev->GetInteger(5);
 
-   SetVariable("other", ev->GetEntity(1));
+   SetVariable(otherVar, ev->GetEntity(1));
    if(!DoAction("killed") && actorthread)
       actorthread->ProcessEvent(EV_ScriptThread_End);
 
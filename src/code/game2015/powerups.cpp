@@ -602,6 +602,7 @@ Goggles::Goggles() : InventoryItem()
    setRespawnTime(60 + G_Random(30));
    goggleson = false;
    flags |= FL_POSTTHINK;
+   Wake();
 }
 
 Goggles::~Goggles()
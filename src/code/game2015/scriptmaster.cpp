@@ -28,6 +28,7 @@
 #include "specialfx.h"
 #include "worldspawn.h"
 #include "player.h"
+#include "../elib/qstring.h"
 
 ScriptVariableList gameVars;
 ScriptVariableList levelVars;
@@ -194,8 +195,191 @@ EXPORT_FROM_DLL void ScriptMaster::KillThreads()
    currentThread = nullptr;
 }
 
+/*
+==============
+=
+= Thread number map
+=
+==============
+*/
+
+void ScriptMaster::AddThreadToMap(ScriptThread *thread)
+{
+   ScriptThread **bucket;
+
+   bucket = &threadHash[(unsigned)thread->threadNum & (SCRIPT_THREAD_HASHSIZE - 1)];
+   thread->nextHashThread = *bucket;
+   *bucket = thread;
+}
+
+void ScriptMaster::RemoveThreadFromMap(ScriptThread *thread)
+{
+   ScriptThread **link;
+
+   for(link = &threadHash[(unsigned)thread->threadNum & (SCRIPT_THREAD_HASHSIZE - 1)]; *link; link = &(*link)->nextHashThread)
+   {
+      if(*link == thread)
+      {
+         *link = thread->nextHashThread;
+         thread->nextHashThread = nullptr;
+         return;
+      }
+   }
+}
+
+/*
+==============
+=
+= Wait registries
+=
+= Each thread has one node per wait type, linked into waitHash by a hash of
+= what it is waiting on.  Waking threads only looks at one bucket.
+=
+==============
+*/
+
+static unsigned WaitThreadHash(ScriptThread *thread)
+{
+   return (unsigned)((size_t)thread >> 4);
+}
+
+void ScriptMaster::LinkWait(ScriptThread *thread, int type, unsigned hash)
+{
+   scriptwait_t  *node;
+   scriptwait_t **bucket;
+
+   node   = &thread->waitNodes[type];
+   bucket = &waitHash[type][hash & (SCRIPT_WAIT_HASHSIZE - 1)];
+
+   node->thread = thread;
+   node->hash = hash;
+   node->next = *bucket;
+   if(node->next)
+   {
+      node->next->prevnext = &node->next;
+   }
+   node->prevnext = bucket;
+   *bucket = node;
+}
+
+void ScriptMaster::UnlinkWaits(ScriptThread *thread)
+{
+   scriptwait_t *node;
+   int           i;
+
+   // nodes aren't valid until the registries are rebuilt
+   if(waitsDirty)
+   {
+      return;
+   }
+
+   for(i = 0; i < NUM_WAIT_TYPES; i++)
+   {
+      node = &thread->waitNodes[i];
+      if(node->prevnext)
+      {
+         *node->prevnext = node->next;
+         if(node->next)
+         {
+            node->next->prevnext = node->prevnext;
+         }
+         node->next = nullptr;
+         node->prevnext = nullptr;
+      }
+   }
+}
+
+//
+// Must be called whenever a thread's waitingForThread, waitingForDeath,
+// waitingForConsole or waitingForVariable changes.
+//
+EXPORT_FROM_DLL void ScriptMaster::UpdateWaits(ScriptThread *thread)
+{
+   if(waitsDirty)
+   {
+      return;
+   }
+
+   UnlinkWaits(thread);
+
+   if(thread->waitingForThread)
+   {
+      LinkWait(thread, WAIT_THREAD, WaitThreadHash(thread->waitingForThread));
+   }
+   if(thread->waitingForDeath.length())
+   {
+      LinkWait(thread, WAIT_DEATH, qstring::HashCodeCaseStatic(thread->waitingForDeath.c_str()));
+   }
+   if(thread->waitingForConsole.length())
+   {
+      LinkWait(thread, WAIT_CONSOLE, qstring::HashCodeCaseStatic(thread->waitingForConsole.c_str()));
+   }
+   if(thread->waitingForVariable.length())
+   {
+      LinkWait(thread, WAIT_VARIABLE, qstring::HashCodeCaseStatic(thread->waitingForVariable.c_str()));
+   }
+}
+
+void ScriptMaster::RebuildWaits()
+{
+   ScriptThread *thread;
+   int           i;
+   int           j;
+   int           n;
+
+   memset(waitHash, 0, sizeof(waitHash));
+   waitsDirty = false;
+
+   n = Threads.NumObjects();
+   for(i = 1; i <= n; i++)
+   {
+      thread = Threads.ObjectAt(i);
+      for(j = 0; j < NUM_WAIT_TYPES; j++)
+      {
+         thread->waitNodes[j].next = nullptr;
+         thread->waitNodes[j].prevnext = nullptr;
+      }
+      UpdateWaits(thread);
+   }
+}
+
+//
+// Gets the threads in the bucket for the hash, in thread number order so that
+// they're woken up in the same order as they would be by walking Threads.
+// Callers still have to check what each thread is waiting on, since the
+// callbacks for one thread may change the state of the others.
+//
+void ScriptMaster::FindWaiters(int type, unsigned hash, Container<ThreadPtr> &list)
+{
+   scriptwait_t *node;
+   ThreadPtr     ptr;
+   int           i;
+
+   if(waitsDirty)
+   {
+      RebuildWaits();
+   }
+
+   for(node = waitHash[type][hash & (SCRIPT_WAIT_HASHSIZE - 1)]; node; node = node->next)
+   {
+      if(node->hash != hash)
+      {
+         continue;
+      }
+
+      ptr = node->thread;
+      list.AddObject(ptr);
+      for(i = list.NumObjects(); (i > 1) && (list.ObjectAt(i - 1)->ThreadNum() > node->thread->ThreadNum()); i--)
+      {
+         list.ObjectAt(i) = list.ObjectAt(i - 1);
+      }
+      list.ObjectAt(i) = node->thread;
+   }
+}
+
 EXPORT_FROM_DLL qboolean ScriptMaster::NotifyOtherThreads(int num)
 {
+   Container<ThreadPtr> waiters;
    ScriptThread *thread1;
    ScriptThread *thread2;
    int i;
@@ -204,12 +388,17 @@ EXPORT_FROM_DLL qboolean ScriptMaster::NotifyOtherThreads(int num)
 
    thread1 = GetThread(num);
    assert(thread1);
-   n = Threads.NumObjects();
+   if(!thread1)
+   {
+      return false;
+   }
+
+   FindWaiters(WAIT_THREAD, WaitThreadHash(thread1), waiters);
+   n = waiters.NumObjects();
    for(i = 1; i <= n; i++)
    {
-      thread2 = Threads.ObjectAt(i);
-      assert(thread2);
-      if(thread2->WaitingOnThread() == thread1)
+      thread2 = waiters.ObjectAt(i);
+      if(thread2 && (thread2->WaitingOnThread() == thread1))
       {
          ev = new Event(EV_ScriptThread_ThreadCallback);
          ev->SetThread(thread1);
@@ -223,28 +412,21 @@ EXPORT_FROM_DLL qboolean ScriptMaster::NotifyOtherThreads(int num)
 
 EXPORT_FROM_DLL void ScriptMaster::DeathMessage(const char *name)
 {
+   Container<ThreadPtr>  waiters;
    ScriptThread         *thread;
    Event                *ev;
    int                  i, n;
 
    // Look for threads that are waiting for this name
-   n = Threads.NumObjects();
+   FindWaiters(WAIT_DEATH, qstring::HashCodeCaseStatic(name), waiters);
+   n = waiters.NumObjects();
    for(i = 1; i <= n; i++)
    {
-      const char *waiting;
-      thread = Threads.ObjectAt(i);
-      assert(thread);
-      if(thread)
+      thread = waiters.ObjectAt(i);
+      if(thread && !strcmp(thread->WaitingOnDeath(), name))
       {
-         waiting = thread->WaitingOnDeath();
-         if(waiting)
-         {
-            if(!strcmp(waiting, name))
-            {
-               ev = new Event(EV_ScriptThread_DeathCallback);
-               thread->ProcessEvent(ev);
-            }
-         }
+         ev = new Event(EV_ScriptThread_DeathCallback);
+         thread->ProcessEvent(ev);
       }
    }
 }
@@ -312,6 +494,7 @@ EXPORT_FROM_DLL void ScriptMaster::CreateConsoleUser(const char *console_name, i
 
 EXPORT_FROM_DLL void ScriptMaster::ConsoleVariable(const char *name, const char *text)
 {
+   Container<ThreadPtr> waiters;
    ScriptThread        *thread;
    ScriptVariable      *var;
    ScriptVariableList  *vars;
@@ -342,30 +525,22 @@ EXPORT_FROM_DLL void ScriptMaster::ConsoleVariable(const char *name, const char
 
    // Look for threads that are waiting for this variable
 
-   n = Threads.NumObjects();
+   FindWaiters(WAIT_VARIABLE, qstring::HashCodeCaseStatic(name), waiters);
+   n = waiters.NumObjects();
    for(i = 1; i <= n; i++)
    {
-      const char *waiting;
-
-      thread = Threads.ObjectAt(i);
-      assert(thread);
-      if(thread)
+      thread = waiters.ObjectAt(i);
+      if(thread && !strcmp(thread->WaitingOnVariable(), name))
       {
-         waiting = thread->WaitingOnVariable();
-         if(waiting)
-         {
-            if(!strcmp(waiting, name))
-            {
-               ev = new Event(EV_ScriptThread_VariableCallback);
-               thread->ProcessEvent(ev);
-            }
-         }
+         ev = new Event(EV_ScriptThread_VariableCallback);
+         thread->ProcessEvent(ev);
       }
    }
 }
 
 EXPORT_FROM_DLL void ScriptMaster::ConsoleInput(const char *name, const char *text)
 {
+   Container<ThreadPtr>  waiters;
    ScriptThread         *thread;
    ScriptVariable	      *var;
    ScriptVariableList	*vars;
@@ -397,23 +572,15 @@ EXPORT_FROM_DLL void ScriptMaster::ConsoleInput(const char *name, const char *te
    // Look for threads that are waiting for input from
    // this console.
 
-   n = Threads.NumObjects();
+   FindWaiters(WAIT_CONSOLE, qstring::HashCodeCaseStatic(name), waiters);
+   n = waiters.NumObjects();
    for(i = 1; i <= n; i++)
    {
-      const char *waiting;
-      thread = Threads.ObjectAt(i);
-      assert(thread);
-      if(thread)
+      thread = waiters.ObjectAt(i);
+      if(thread && !strcmp(thread->WaitingOnConsole(), name))
       {
-         waiting = thread->WaitingOnConsole();
-         if(waiting)
-         {
-            if(!strcmp(waiting, name))
-            {
-               ev = new Event(EV_ScriptThread_ConsoleCallback);
-               thread->ProcessEvent(ev);
-            }
-         }
+         ev = new Event(EV_ScriptThread_ConsoleCallback);
+         thread->ProcessEvent(ev);
       }
    }
 }
@@ -441,32 +608,102 @@ EXPORT_FROM_DLL qboolean ScriptMaster::KillThread(int num)
 EXPORT_FROM_DLL qboolean ScriptMaster::RemoveThread(int num)
 {
    ScriptThread *thread;
-   int i;
-   int n;
 
    // Must be safely reentryable so that the thread destructor can tell us that it's being deleted.
-   n = Threads.NumObjects();
-   for(i = 1; i <= n; i++)
+   thread = GetThread(num);
+   if(!thread)
    {
-      thread = Threads.ObjectAt(i);
-      assert(thread);
-      if(thread)
-      {
-         if(thread->ThreadNum() == num)
-         {
-            Threads.RemoveObjectAt(i);
-            if(currentThread == thread)
-            {
-               SetCurrentThread(NULL);
-            }
-            return true;
-         }
-      }
+      return false;
+   }
+
+   RemoveThreadFromMap(thread);
+   UnlinkWaits(thread);
+   Threads.RemoveObject(thread);
+   if(currentThread == thread)
+   {
+      SetCurrentThread(NULL);
+   }
+
+   return true;
+}
+
+/*
+==============
+=
+= Script scheduling
+=
+= Each thread gets g_scriptbudget instructions every time it's run.  A thread
+= that uses up its budget without stopping is suspended as if it had done a
+= "wait" for one frame, so it's saved, restored and goto'd exactly the same
+= way as a waiting thread.  g_scriptframetime does the same for all threads
+= once scripts have used that many milliseconds in a frame.  That one depends
+= on the speed of the machine, so leave it off when determinism matters.
+=
+==============
+*/
+EXPORT_FROM_DLL void ScriptMaster::BeginFrame()
+{
+   // no threads are running between frames, even if an error left us thinking so
+   scriptDepth       = 0;
+   frameScriptTime   = 0;
+   frameInstructions = 0;
+   frameYields       = 0;
+}
+
+EXPORT_FROM_DLL void ScriptMaster::EnterScript()
+{
+   // threads started by other threads are counted as part of their parent
+   if(!scriptDepth++)
+   {
+      scriptStart = G_Microseconds();
+   }
+}
+
+EXPORT_FROM_DLL void ScriptMaster::LeaveScript(int instructions, qboolean yielded)
+{
+   frameInstructions += instructions;
+   if(yielded)
+   {
+      frameYields++;
+   }
+
+   if(!--scriptDepth)
+   {
+      frameScriptTime += G_Microseconds() - scriptStart;
+   }
+}
+
+EXPORT_FROM_DLL qboolean ScriptMaster::SliceExpired(int instructions)
+{
+   if(g_scriptbudget->value && (instructions >= g_scriptbudget->value))
+   {
+      return true;
+   }
+
+   // only check the time every so often
+   if(g_scriptframetime->value && !(instructions & 15))
+   {
+      return (frameScriptTime + (G_Microseconds() - scriptStart)) >= (unsigned)(g_scriptframetime->value * 1000);
    }
 
    return false;
 }
 
+EXPORT_FROM_DLL unsigned ScriptMaster::FrameScriptTime()
+{
+   return frameScriptTime;
+}
+
+EXPORT_FROM_DLL int ScriptMaster::FrameInstructions()
+{
+   return frameInstructions;
+}
+
+EXPORT_FROM_DLL int ScriptMaster::FrameYields()
+{
+   return frameYields;
+}
+
 EXPORT_FROM_DLL ScriptThread *ScriptMaster::CurrentThread()
 {
    return currentThread;
@@ -481,6 +718,7 @@ EXPORT_FROM_DLL ScriptThread *ScriptMaster::CreateThread(GameScript *scr, const
 {
    ScriptThread *thread;
    int threadnum;
+   qboolean success;
 
    thread = new ScriptThread();
 
@@ -488,7 +726,11 @@ EXPORT_FROM_DLL ScriptThread *ScriptMaster::CreateThread(GameScript *scr, const
    threadnum = GetUniqueThreadNumber();
    Threads.AddObject(thread);
 
-   if(!thread->Setup(threadnum, scr, label))
+   // Setup sets the thread number even when it fails
+   success = thread->Setup(threadnum, scr, label);
+   AddThreadToMap(thread);
+
+   if(!success)
    {
       KillThread(threadnum);
       return nullptr;
@@ -516,21 +758,13 @@ EXPORT_FROM_DLL ScriptThread *ScriptMaster::CreateThread(const char *name, scrip
 
 EXPORT_FROM_DLL ScriptThread *ScriptMaster::GetThread(int num)
 {
-   int i;
-   int n;
    ScriptThread *thread;
 
-   n = Threads.NumObjects();
-   for(i = 1; i <= n; i++)
+   for(thread = threadHash[(unsigned)num & (SCRIPT_THREAD_HASHSIZE - 1)]; thread; thread = thread->nextHashThread)
    {
-      thread = Threads.ObjectAt(i);
-      assert(thread);
-      if(thread)
+      if(thread->threadNum == num)
       {
-         if(thread->ThreadNum() == num)
-         {
-            return thread;
-         }
+         return thread;
       }
    }
 
@@ -564,10 +798,7 @@ EXPORT_FROM_DLL qboolean ScriptMaster::Goto(GameScript *scr, const char *name)
 
 EXPORT_FROM_DLL ScriptVariableList *ScriptMaster::GetVarGroup(const char *name)
 {
-   ScriptVariableList *vars;
    const char *v;
-   char	vargroup[20];
-   int	len;
 
    v = strchr(name, '.');
    if(!v)
@@ -575,37 +806,39 @@ EXPORT_FROM_DLL ScriptVariableList *ScriptMaster::GetVarGroup(const char *name)
       return nullptr;
    }
 
-   len = v - name;
-   if(len > sizeof(vargroup) - 1)
+   switch(v - name)
    {
-      len = sizeof(vargroup) - 1;
-   }
-   memset(vargroup, 0, sizeof(vargroup));
-   strncpy(vargroup, name, len);
+   case 4:
+      if(!strncmp(name, "game", 4))
+      {
+         return &gameVars;
+      }
+      if(!strncmp(name, "parm", 4))
+      {
+         return &parmVars;
+      }
+      break;
 
-   vars = nullptr;
-   if(!strcmp(vargroup, "game"))
-   {
-      vars = &gameVars;
-   }
-   else if(!strcmp(vargroup, "level"))
-   {
-      vars = &levelVars;
-   }
-   else if(!strcmp(vargroup, "local") && currentThread)
-   {
-      vars = currentThread->Vars();
-   }
-   else if(!strcmp(vargroup, "parm"))
-   {
-      vars = &parmVars;
-   }
-   else if(!strcmp(vargroup, "console"))
-   {
-      vars = &consoleVars;
+   case 5:
+      if(!strncmp(name, "level", 5))
+      {
+         return &levelVars;
+      }
+      if(!strncmp(name, "local", 5) && currentThread)
+      {
+         return currentThread->Vars();
+      }
+      break;
+
+   case 7:
+      if(!strncmp(name, "console", 7))
+      {
+         return &consoleVars;
+      }
+      break;
    }
 
-   return vars;
+   return nullptr;
 }
 
 EXPORT_FROM_DLL ScriptVariable *ScriptMaster::GetExistingVariable(const char *name)
@@ -759,6 +992,7 @@ ScriptThread::ScriptThread() : Listener()
 
 ScriptThread::~ScriptThread()
 {
+   ClearWaitFor();
    Director.NotifyOtherThreads(threadNum);
    Director.RemoveThread(threadNum);
 }
@@ -773,6 +1007,8 @@ EXPORT_FROM_DLL void ScriptThread::ClearWaitFor()
    waitingForVariable = "";
    waitingForDeath    = "";
    waitingForPlayer   = false;
+
+   Director.UpdateWaits(this);
 }
 
 EXPORT_FROM_DLL void ScriptThread::SetType(scripttype_t newtype)
@@ -874,11 +1110,11 @@ EXPORT_FROM_DLL qboolean ScriptThread::SetScript(const char *name)
    return false;
 }
 
-EXPORT_FROM_DLL qboolean ScriptThread::Goto(const char *name)
+EXPORT_FROM_DLL qboolean ScriptThread::Goto(const char *name, scriptlabelref_t *ref)
 {
    qboolean result;
 
-   result = ScriptLib.Goto(&script, name);
+   result = ScriptLib.Goto(&script, name, ref);
    if(result)
    {
       // Cancel pending execute events when waitUntil is set
@@ -909,6 +1145,7 @@ EXPORT_FROM_DLL void ScriptThread::Mark(ThreadMarker *mark)
    mark->waitingForDeath    = waitingForDeath;
    mark->waitingForPlayer   = waitingForPlayer;
    mark->waitingNumObjects  = waitingNumObjects;
+   mark->yieldedInstructions = yieldedInstructions;
    if(waitUntil)
    {
       // add one so that 0 is always reserved for no wait
@@ -936,6 +1173,8 @@ EXPORT_FROM_DLL void ScriptThread::Restore(ThreadMarker *mark)
    waitingForDeath    = mark->waitingForDeath;
    waitingForPlayer   = mark->waitingForPlayer;
    waitingNumObjects  = mark->waitingNumObjects;
+   yieldedInstructions = mark->yieldedInstructions;
+   Director.UpdateWaits(this);
 
    script.Restore(&mark->scriptmarker);
 
@@ -951,24 +1190,43 @@ EXPORT_FROM_DLL void ScriptThread::Restore(ThreadMarker *mark)
 
 EXPORT_FROM_DLL TargetList *ScriptThread::GetTargetList(str &targetname)
 {
-   TargetList *tlist;
-   int num;
+   // the world hashes its target lists, so there's no need to keep a copy per thread
+   return world->GetTargetList(targetname);
+}
+
+//
+// Adds the entity to the list of objects to notify in DoMove.  Returns false if it was already in the list.
+//
+EXPORT_FROM_DLL qboolean ScriptThread::AddToUpdateList(int entnum)
+{
+   unsigned bit;
+
+   bit = 1u << (entnum & 31);
+   if(updateBits[entnum >> 5] & bit)
+   {
+      return false;
+   }
+
+   updateBits[entnum >> 5] |= bit;
+   updateList.AddObject(entnum);
+
+   return true;
+}
+
+EXPORT_FROM_DLL void ScriptThread::ClearUpdateList()
+{
    int i;
+   int num;
+   int entnum;
 
-   num = targets.NumObjects();
+   num = updateList.NumObjects();
    for(i = 1; i <= num; i++)
    {
-      tlist = targets.ObjectAt(i);
-      if(targetname == tlist->targetname)
-      {
-         return tlist;
-      }
+      entnum = updateList.ObjectAt(i);
+      updateBits[entnum >> 5] &= ~(1u << (entnum & 31));
    }
 
-   tlist = world->GetTargetList(targetname);
-   targets.AddObject(tlist);
-
-   return tlist;
+   updateList.ClearObjectList();
 }
 
 EXPORT_FROM_DLL void ScriptThread::SendCommandToSlaves(const char *name, Event *ev)
@@ -983,6 +1241,13 @@ EXPORT_FROM_DLL void ScriptThread::SendCommandToSlaves(const char *name, Event *
    {
       tlist = GetTargetList(str(name + 1));
       num = tlist->list.NumObjects();
+
+      // every copy of the event shares the same arguments
+      if(num > 1)
+      {
+         ev->ShareArgs();
+      }
+
       for(i = 1; i <= num; i++)
       {
          ent = tlist->list.ObjectAt(i);
@@ -991,10 +1256,8 @@ EXPORT_FROM_DLL void ScriptThread::SendCommandToSlaves(const char *name, Event *
 
          sendevent = new Event(*ev);
 
-         if(!updateList.ObjectInList(ent->entnum))
+         if(AddToUpdateList(ent->entnum))
          {
-            updateList.AddObject(ent->entnum);
-
             // Tell the object that we're about to send it some orders
             ent->ProcessEvent(EV_Script_NewOrders);
          }
@@ -1014,7 +1277,6 @@ qboolean ScriptThread::FindEvent(const char *name)
    if(!Event::Exists(name))
    {
       ScriptError("Unknown command '%s'\n", name);
-      script.SkipToEOL();
       return false;
    }
 
@@ -1159,6 +1421,117 @@ EXPORT_FROM_DLL void ScriptThread::ProcessCommand(int argc, const char **argv)
    }
 }
 
+//
+// Same as ProcessCommand, but uses the target kind and event number that were
+// resolved when the script was compiled.
+//
+EXPORT_FROM_DLL void ScriptThread::ProcessInstruction(const scriptinstruction_t *instr, int argc, const char **argv)
+{
+   const char *command;
+   int         eventnum;
+   Event      *event;
+   Entity     *ent;
+
+   if(instr->type == SCRIPT_INSTR_LABEL)
+   {
+      return;
+   }
+
+   if(instr->type == SCRIPT_INSTR_VARIABLE)
+   {
+      ProcessCommand(argc, argv);
+      return;
+   }
+
+   if(instr->type == SCRIPT_INSTR_GLOBAL)
+   {
+      command = argv[0];
+   }
+   else
+   {
+      command = (argc > 1) ? argv[1] : "";
+   }
+
+   // the command may have been registered after the script was loaded
+   eventnum = instr->eventnum;
+   if(!eventnum)
+   {
+      eventnum = Event::GetEventNum(command);
+      if(!eventnum)
+      {
+         ScriptError("Unknown command '%s'\n", command);
+         return;
+      }
+   }
+
+   switch(instr->type)
+   {
+   case SCRIPT_INSTR_OBJECT:
+      event = new Event(eventnum);
+      event->SetSource(EV_FROM_SCRIPT);
+      event->SetThread(this);
+      event->SetLineNumber(linenumber);
+      event->AddTokens(argc - 2, &argv[2]);
+      SendCommandToSlaves(argv[0], event);
+      break;
+
+   case SCRIPT_INSTR_SURFACE:
+      event = new Event(eventnum);
+      event->SetSource(EV_FROM_SCRIPT);
+      event->SetThread(this);
+      event->SetLineNumber(linenumber);
+      event->AddToken(&argv[0][1]);
+      event->AddTokens(argc - 2, &argv[2]);
+      surfaceManager.ProcessEvent(event);
+      break;
+
+   case SCRIPT_INSTR_CONSOLE:
+      event = new Event(eventnum);
+      event->SetSource(EV_FROM_SCRIPT);
+      event->SetThread(this);
+      event->SetLineNumber(linenumber);
+      event->AddToken(&argv[0][1]);
+      event->AddTokens(argc - 2, &argv[2]);
+      consoleManager.ProcessEvent(event);
+      break;
+
+   case SCRIPT_INSTR_ENTNUM:
+      if(!IsNumeric(&argv[0][1]))
+      {
+         ScriptError("Expecting numeric value for * command, but found '%s'\n", &argv[0][1]);
+         break;
+      }
+
+      ent = G_GetEntity(atoi(&argv[0][1]));
+      if(ent)
+      {
+         event = new Event(eventnum);
+         event->SetSource(EV_FROM_SCRIPT);
+         event->SetThread(this);
+         event->SetLineNumber(linenumber);
+         event->AddTokens(argc - 2, &argv[2]);
+         ent->ProcessEvent(event);
+      }
+      else
+      {
+         ScriptError("Entity not found for * command\n");
+      }
+      break;
+
+   default:
+      event = new Event(eventnum);
+      event->SetSource(EV_FROM_SCRIPT);
+      event->SetThread(this);
+      event->SetLineNumber(linenumber);
+      event->AddTokens(argc - 1, &argv[1]);
+      if(!ProcessEvent(event))
+      {
+         ScriptError("Invalid global command '%s'\n", command);
+      }
+      break;
+   }
+}
+
 EXPORT_FROM_DLL void ScriptThread::ProcessCommandFromEvent(Event *ev, int startarg)
 {
    int			argc;
@@ -1200,14 +1573,330 @@ EXPORT_FROM_DLL void ScriptThread::Start(float delay)
       PostEvent(EV_ScriptThread_Execute, delay);
 }
 
+/*
+===============================================================================
+
+Script profiler
+
+When g_profilescripts is set, every script instruction that's executed is
+timed and added up by script and label.  Set it to 2 to also keep totals for
+each line.  Time and events don't include instructions run by other threads
+that were started from the line, those are counted against the other thread.
+A wake is counted against the label a thread resumes in each time it starts
+executing.
+
+  sv scriptprof [top [count] [labels|lines|files]]
+  sv scriptprof csv <filename>
+  sv scriptprof reset
+
+===============================================================================
+*/
+
+#define SCRIPT_PROFILE_HASHSIZE 1024
+
+typedef struct scriptprofile_s
+{
+   const char              *file;      // interned
+   const char              *label;     // interned, empty for code before the first label
+   int                      line;      // 0 for label totals
+   int                      instructions;
+   int                      events;
+   int                      wakes;
+   double                   time;      // microseconds
+   struct scriptprofile_s  *next;
+} scriptprofile_t;
+
+static scriptprofile_t *scriptProfileHash[SCRIPT_PROFILE_HASHSIZE];
+static int              numScriptProfiles = 0;
+
+// time and events used by threads started from the instruction that's running
+static unsigned         scriptProfileChildTime = 0;
+static unsigned         scriptProfileChildEvents = 0;
+
+static scriptprofile_t *GetScriptProfile(GameScript *script, int label, int line)
+{
+   scriptprofile_t *p;
+   const char      *file;
+   const char      *name;
+   unsigned         hash;
+
+   file = G_InternScriptString(script->Filename());
+   name = G_InternScriptString(script->LabelName(label));
+
+   hash = ((unsigned)((size_t)file >> 4) ^ (unsigned)((size_t)name >> 4) * 31 ^ (unsigned)line * 131) % SCRIPT_PROFILE_HASHSIZE;
+   for(p = scriptProfileHash[hash]; p; p = p->next)
+   {
+      if((p->file == file) && (p->label == name) && (p->line == line))
+      {
+         return p;
+      }
+   }
+
+   p = new scriptprofile_t;
+   memset(p, 0, sizeof(*p));
+   p->file  = file;
+   p->label = name;
+   p->line  = line;
+   p->next  = scriptProfileHash[hash];
+   scriptProfileHash[hash] = p;
+   numScriptProfiles++;
+
+   return p;
+}
+
+static void ResetScriptProfile(void)
+{
+   scriptprofile_t *p;
+   scriptprofile_t *next;
+   int              i;
+
+   for(i = 0; i < SCRIPT_PROFILE_HASHSIZE; i++)
+   {
+      for(p = scriptProfileHash[i]; p; p = next)
+      {
+         next = p->next;
+         delete p;
+      }
+      scriptProfileHash[i] = nullptr;
+   }
+
+   numScriptProfiles = 0;
+}
+
+typedef enum
+{
+   SCRIPTPROF_LABELS,
+   SCRIPTPROF_LINES,
+   SCRIPTPROF_FILES
+} scriptprofview_t;
+
+static int compareScriptProfiles(const void *arg1, const void *arg2)
+{
+   const scriptprofile_t *p1 = (const scriptprofile_t *)arg1;
+   const scriptprofile_t *p2 = (const scriptprofile_t *)arg2;
+
+   // most time first
+   if(p1->time != p2->time)
+   {
+      return (p1->time < p2->time) ? 1 : -1;
+   }
+
+   return p2->instructions - p1->instructions;
+}
+
+//
+// Gathers up everything that was profiled for the view, sorted by time.
+// Returns the number of entries.
+//
+static int GetScriptProfileEntries(scriptprofview_t view, scriptprofile_t **entries)
+{
+   scriptprofile_t *e;
+   scriptprofile_t *p;
+   int              num;
+   int              i;
+   int              j;
+
+   e = new scriptprofile_t[numScriptProfiles + 1];
+   num = 0;
+   for(i = 0; i < SCRIPT_PROFILE_HASHSIZE; i++)
+   {
+      for(p = scriptProfileHash[i]; p; p = p->next)
+      {
+         if((view == SCRIPTPROF_LINES) != (p->line != 0))
+         {
+            continue;
+         }
+
+         if(view == SCRIPTPROF_FILES)
+         {
+            for(j = 0; j < num; j++)
+            {
+               if(e[j].file == p->file)
+               {
+                  e[j].instructions += p->instructions;
+                  e[j].events       += p->events;
+                  e[j].wakes        += p->wakes;
+                  e[j].time         += p->time;
+                  break;
+               }
+            }
+
+            if(j < num)
+            {
+               continue;
+            }
+         }
+
+         e[num] = *p;
+         num++;
+      }
+   }
+
+   qsort(e, num, sizeof(scriptprofile_t), compareScriptProfiles);
+
+   *entries = e;
+   return num;
+}
+
+static void PrintScriptProfile(scriptprofview_t view, int count)
+{
+   scriptprofile_t *entries;
+   scriptprofile_t *p;
+   str              name;
+   int              num;
+   int              i;
+
+   num = GetScriptProfileEntries(view, &entries);
+   if(count > num)
+   {
+      count = num;
+   }
+
+   gi.printf("%-40s %8s %10s %8s %8s %8s\n", (view == SCRIPTPROF_FILES) ? "file" : "label", "wakes", "instrs", "events", "ms", "avg us");
+   gi.printf("---------------------------------------- -------- ---------- -------- -------- --------\n");
+   for(i = 0; i < count; i++)
+   {
+      p = &entries[i];
+      name = p->file;
+      if(view != SCRIPTPROF_FILES)
+      {
+         name += "::";
+         name += p->label;
+         if(view == SCRIPTPROF_LINES)
+         {
+            name += va("(%d)", p->line);
+         }
+      }
+
+      gi.printf("%-40s %8d %10d %8d %8.2f %8.1f\n", name.c_str(), p->wakes, p->instructions, p->events,
+                p->time / 1000.0, p->instructions ? p->time / p->instructions : 0.0);
+   }
+
+   delete [] entries;
+}
+
+static void WriteScriptProfile(const char *filename)
+{
+   FILE            *f;
+   char             name[MAX_OSPATH];
+   scriptprofile_t *entries;
+   scriptprofile_t *p;
+   cvar_t          *game;
+   int              num;
+   int              i;
+   int              view;
+
+   game = gi.cvar("game", "", 0);
+
+   if(!*game->string)
+   {
+      snprintf(name, sizeof(name), "%s/%s", GAMEVERSION, filename);
+   }
+   else
+   {
+      snprintf(name, sizeof(name), "%s/%s", game->string, filename);
+   }
+
+   gi.printf("Writing %s.\n", name);
+
+   f = fopen(name, "wt");
+   if(!f)
+   {
+      gi.printf("Couldn't open %s\n", name);
+      return;
+   }
+
+   fprintf(f, "file,label,line,wakes,instructions,events,time_us\n");
+   for(view = SCRIPTPROF_LABELS; view <= SCRIPTPROF_LINES; view++)
+   {
+      num = GetScriptProfileEntries((scriptprofview_t)view, &entries);
+      for(i = 0; i < num; i++)
+      {
+         p = &entries[i];
+         fprintf(f, "%s,%s,%d,%d,%d,%d,%.0f\n", p->file, p->label, p->line, p->wakes, p->instructions, p->events, p->time);
+      }
+      delete [] entries;
+   }
+
+   fclose(f);
+}
+
+EXPORT_FROM_DLL void G_ScriptProfileCommand(void)
+{
+   const char       *cmd;
+   int               count;
+   scriptprofview_t  view;
+   int               i;
+
+   cmd = gi.argv(2);
+   if(!Q_stricmp(cmd, "reset"))
+   {
+      ResetScriptProfile();
+      return;
+   }
+
+   if(!numScriptProfiles)
+   {
+      gi.printf("No scripts profiled.  Set g_profilescripts to 1 (or 2 for lines) to start.\n");
+      return;
+   }
+
+   if(!Q_stricmp(cmd, "csv"))
+   {
+      if(gi.argc() < 4)
+      {
+         gi.printf("Usage: sv scriptprof csv <filename>\n");
+         return;
+      }
+
+      WriteScriptProfile(gi.argv(3));
+      return;
+   }
+
+   // top [count] [labels|lines|files]
+   count = 20;
+   view = SCRIPTPROF_LABELS;
+   for(i = 3; i < gi.argc(); i++)
+   {
+      if(!Q_stricmp(gi.argv(i), "lines"))
+      {
+         view = SCRIPTPROF_LINES;
+      }
+      else if(!Q_stricmp(gi.argv(i), "files"))
+      {
+         view = SCRIPTPROF_FILES;
+      }
+      else if(atoi(gi.argv(i)) > 0)
+      {
+         count = atoi(gi.argv(i));
+      }
+   }
+
+   PrintScriptProfile(view, count);
+}
+
+static ScriptVariableSlot parmCurrentThread("currentthread");
+static ScriptVariableSlot parmPreviousThread("previousthread");
+
 EXPORT_FROM_DLL void ScriptThread::Execute(Event *ev)
 {
    int num;
    ScriptThread *oldthread;
    int argc;
-   const char *argv[MAX_COMMANDS];
-   char args[MAX_COMMANDS][MAXTOKEN];
+   const char **argv;
+   const scriptinstruction_t *instr;
    ScriptVariable	*var;
+   int profiling;
+   const scriptprogram_t *profprogram;
+   int proflabel;
+   scriptprofile_t *labelprof;
+   scriptprofile_t *lineprof;
+   unsigned parenttime;
+   unsigned parentevents;
+   unsigned elapsed;
+   unsigned events;
+   int slice;
+   qboolean yielded;
 
    if(threadDying)
    {
@@ -1224,7 +1913,7 @@ EXPORT_FROM_DLL void ScriptThread::Execute(Event *ev)
 
    // clear the updateList so that all objects moved this frame are notified before they receive any commands
    // we have to do this here as well as in DoMove, since DoMove may not be called
-   updateList.ClearObjectList();
+   ClearUpdateList();
 
    oldthread = Director.CurrentThread();
    Director.SetCurrentThread(this);
@@ -1237,7 +1926,7 @@ EXPORT_FROM_DLL void ScriptThread::Execute(Event *ev)
 
    ClearWaitFor();
 
-   var = Director.GetVariable("parm.previousthread");
+   var = parmPreviousThread.Resolve(&parmVars);
    if(oldthread)
    {
       var->setIntValue(oldthread->ThreadNum());
@@ -1247,54 +1936,121 @@ EXPORT_FROM_DLL void ScriptThread::Execute(Event *ev)
       var->setIntValue(0);
    }
 
-   var = Director.GetVariable("parm.currentthread");
+   var = parmCurrentThread.Resolve(&parmVars);
 
    doneProcessing = false;
 
-   num = 0;
+   profiling   = (int)g_profilescripts->value;
+   profprogram = nullptr;
+   proflabel   = 0;
+   labelprof   = nullptr;
+   lineprof    = nullptr;
+
+   Director.EnterScript();
+
+   // the overflow check carries over from slices that ran out of budget
+   num = yieldedInstructions;
+   slice = 0;
+   yielded = false;
    while((num++ < 10000) && !doneProcessing && !threadDying)
    {
       // keep our thread number up to date
       var->setIntValue(threadNum);
 
-      script.SkipNonToken(true);
+      instr = script.NextInstruction(&argc, &argv);
 
       // save the line number for errors
-      linenumber = script.GetLineNumber();
+      linenumber = instr->line;
 
-      argc = 0;
-      while(script.TokenAvailable(false))
+      if(profiling)
       {
-         if(argc >= MAX_COMMANDS)
+         // only look up the profile when we move to another label or line
+         if((script.Program() != profprogram) || (instr->label != proflabel))
          {
-            ScriptError("Line exceeds %d command limit", MAX_COMMANDS);
-            script.SkipToEOL();
-            break;
+            labelprof = GetScriptProfile(&script, instr->label, 0);
+            if(!profprogram)
+            {
+               // first instruction since the thread woke up
+               labelprof->wakes++;
+            }
+            profprogram = script.Program();
+            proflabel   = instr->label;
+            lineprof    = nullptr;
          }
-         strcpy(args[argc], script.GetToken(false));
-         argv[argc] = args[argc];
-         argc++;
+
+         if((profiling > 1) && (!lineprof || (lineprof->line != instr->line)))
+         {
+            lineprof = GetScriptProfile(&script, instr->label, instr->line);
+         }
+
+         parenttime   = scriptProfileChildTime;
+         parentevents = scriptProfileChildEvents;
+         scriptProfileChildTime   = 0;
+         scriptProfileChildEvents = 0;
+         events  = eventsDispatched;
+         elapsed = G_Microseconds();
       }
 
-      assert(argc > 0);
+      if(argc > MAX_COMMANDS)
+      {
+         ScriptError("Line exceeds %d command limit", MAX_COMMANDS);
+         argc = MAX_COMMANDS;
+      }
 
-      // Ignore labels
-      if(args[0][strlen(args[0]) - 1] != ':')
+      if(argc == instr->numtokens)
+      {
+         ProcessInstruction(instr, argc, argv);
+      }
+      // we jumped to a label in the middle of the line, or the line was too long
+      else if(argv[0][strlen(argv[0]) - 1] != ':')
       {
          ProcessCommand(argc, argv);
       }
+
+      if(profiling)
+      {
+         elapsed = G_Microseconds() - elapsed;
+         events  = eventsDispatched - events;
+
+         labelprof->instructions++;
+         labelprof->time   += elapsed - scriptProfileChildTime;
+         labelprof->events += events - scriptProfileChildEvents;
+         if(lineprof)
+         {
+            lineprof->instructions++;
+            lineprof->time   += elapsed - scriptProfileChildTime;
+            lineprof->events += events - scriptProfileChildEvents;
+         }
+
+         scriptProfileChildTime   = parenttime + elapsed;
+         scriptProfileChildEvents = parentevents + events;
+      }
+
+      slice++;
+      if(!doneProcessing && !threadDying && Director.SliceExpired(slice))
+      {
+         // out of time for this frame, pick up where we left off on the next one
+         DoMove();
+         waitUntil = level.time + FRAMETIME;
+         Start(FRAMETIME);
+         yielded = true;
+         break;
+      }
    }
 
-   if(!doneProcessing)
+   Director.LeaveScript(slice, yielded);
+   yieldedInstructions = yielded ? num : 0;
+
+   if(!doneProcessing && !yielded)
    {
       gi.error("Command overflow.  Possible infinite loop in thread '%s'.\n"
-               "Stopping on line %d of %s\n", threadName.c_str(), script.GetLineNumber(), script.Filename());
+               "Stopping on line %d of %s\n", threadName.c_str(), linenumber, script.Filename());
    }
 
    Director.SetCurrentThread(oldthread);
 
    // Set the thread number on exit, in case we were called by someone who wants to know our thread
-   var = Director.GetVariable("parm.previousthread");
+   var = parmPreviousThread.Resolve(&parmVars);
    var->setIntValue(threadNum);
 }
 
@@ -1488,19 +2244,13 @@ void ScriptThread::EventWaitFor(Event *ev)
             {
                tent = tlist->list.ObjectAt(i);
                // add the object to the update list to make sure we tell it to do a move
-               if(!updateList.ObjectInList(tent->entnum))
-               {
-                  updateList.AddObject(tent->entnum);
-               }
+               AddToUpdateList(tent->entnum);
             }
          }
       }
 
       // add the object to the update list to make sure we tell it to do a move
-      if(!updateList.ObjectInList(ent->entnum))
-      {
-         updateList.AddObject(ent->entnum);
-      }
+      AddToUpdateList(ent->entnum);
    }
 
    DoMove();
@@ -1512,6 +2262,7 @@ void ScriptThread::EventWaitForThread(Event *ev)
 
    ClearWaitFor();
    waitingForThread = Director.GetThread(ev->GetInteger(1));
+   Director.UpdateWaits(this);
    if(!waitingForThread)
    {
       ev->Error("EventWaitForThread", "Thread %d not running", ev->GetInteger(1));
@@ -1527,6 +2278,7 @@ void ScriptThread::EventWaitForDeath(Event *ev)
 
    ClearWaitFor();
    waitingForDeath = ev->GetString(1);
+   Director.UpdateWaits(this);
    if(!waitingForDeath.length())
    {
       ev->Error("EventWaitForDeath", "Null name");
@@ -1542,6 +2294,7 @@ void ScriptThread::EventWaitForConsole(Event *ev)
 
    ClearWaitFor();
    waitingForConsole = ev->GetString(1);
+   Director.UpdateWaits(this);
 
    if(!waitingForConsole.length())
    {
@@ -1558,6 +2311,7 @@ void ScriptThread::EventWaitForVariable(Event *ev)
 
    ClearWaitFor();
    waitingForVariable = ev->GetString(1);
+   Director.UpdateWaits(this);
 
    if(!waitingForVariable.length())
    {
@@ -1838,7 +2592,7 @@ EXPORT_FROM_DLL void ScriptThread::DoMove()
       }
    }
 
-   updateList.ClearObjectList();
+   ClearUpdateList();
 }
 
 void ScriptThread::TriggerEvent(Event *ev)
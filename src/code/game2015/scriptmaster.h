@@ -83,21 +83,48 @@ typedef SafePtr<ScriptThread> ThreadPtr;
 
 class ThreadMarker;
 
+//
+// Threads that are waiting on another thread, a death, a console or a
+// variable are linked into a hash table by what they are waiting on, so
+// waking them up doesn't require scanning every thread.
+//
+typedef enum
+{
+   WAIT_THREAD,
+   WAIT_DEATH,
+   WAIT_CONSOLE,
+   WAIT_VARIABLE,
+   NUM_WAIT_TYPES
+} scriptwaittype_t;
+
+#define SCRIPT_WAIT_HASHSIZE   256
+#define SCRIPT_THREAD_HASHSIZE 256
+
+typedef struct scriptwait_s
+{
+   ScriptThread         *thread;
+   unsigned              hash;
+   struct scriptwait_s  *next;
+   struct scriptwait_s **prevnext;    // nullptr when not linked
+} scriptwait_t;
+
 class EXPORT_FROM_DLL ScriptThread : public Listener
 {
+   friend class ScriptMaster;
+
 protected:
    int                     threadNum;
    str                     threadName;
 
    scripttype_t            type;
    GameScript              script;
-   Container<TargetList *> targets;
 
    int                     linenumber;
    qboolean                doneProcessing;
    qboolean                threadDying;
 
    Container<int>          updateList;
+   unsigned                updateBits[(MAX_EDICTS + 31) / 32] = {};   // entnums in updateList
    float                   waitUntil;
    str                     waitingFor;
    ScriptThread           *waitingForThread;
@@ -106,8 +133,15 @@ protected:
    str                     waitingForDeath;
    qboolean                waitingForPlayer;
    int                     waitingNumObjects;
+
+   // instructions run in earlier slices since the thread last stopped on its own
+   int                     yieldedInstructions = 0;
    ScriptVariableList      localVars;
 
+   // maintained by ScriptMaster
+   scriptwait_t            waitNodes[NUM_WAIT_TYPES] = {};
+   ScriptThread           *nextHashThread = nullptr;
+
    void                 ObjectMoveDone(Event *ev);
    void                 CreateThread(Event *ev);
    void                 TerminateThread(Event *ev);
@@ -159,6 +193,8 @@ protected:
    void                 SetCvarEvent(Event *ev);
 
    TargetList           *GetTargetList(str &targetname);
+   qboolean              AddToUpdateList(int entnum);
+   void                  ClearUpdateList();
 
    void                 CueCamera(Event *ev);
    void                 CuePlayer(Event *ev);
@@ -224,7 +260,7 @@ public:
    ScriptVariableList  *Vars();
    qboolean             Setup(int num, GameScript *scr, const char *label);
    qboolean             SetScript(const char *name);
-   qboolean             Goto(const char *name);
+   qboolean             Goto(const char *name, scriptlabelref_t *ref = nullptr);
    qboolean             labelExists(const char *name);
    void                 Start(float delay);
 
@@ -234,6 +270,7 @@ public:
    void                 SendCommandToSlaves(const char *name, Event *ev);
    qboolean             FindEvent(const char *name);
    void                 ProcessCommand(int argc, const char **argv);
+   void                 ProcessInstruction(const scriptinstruction_t *instr, int argc, const char **argv);
    void                 ProcessCommandFromEvent(Event *ev, int startarg);
    virtual void         Archive(Archiver &arc)   override;
    virtual void         Unarchive(Archiver &arc) override;
@@ -249,9 +286,6 @@ inline EXPORT_FROM_DLL void ScriptThread::Archive(Archiver &arc)
 
    arc.WriteObject(&script);
 
-   // targets
-   // don't need to save out targets
-
    arc.WriteInteger(linenumber);
    arc.WriteBoolean(doneProcessing);
    arc.WriteBoolean(threadDying);
@@ -260,6 +294,7 @@ inline EXPORT_FROM_DLL void ScriptThread::Archive(Archiver &arc)
    // don't need to save out updatelist
 
    arc.WriteFloat(waitUntil);
+   arc.WriteInteger(yieldedInstructions);
    arc.WriteString(waitingFor);
    arc.WriteObjectPointer(waitingForThread);
    arc.WriteString(waitingForConsole);
@@ -283,19 +318,16 @@ inline EXPORT_FROM_DLL void ScriptThread::Unarchive(Archiver &arc)
 
    arc.ReadObject(&script);
 
-   // targets
-   // don't need to load out targets
-   targets.ClearObjectList();
-
    arc.ReadInteger(&linenumber);
    arc.ReadBoolean(&doneProcessing);
    arc.ReadBoolean(&threadDying);
 
    // updateList
    // don't need to save out updatelist
-   updateList.ClearObjectList();
+   ClearUpdateList();
 
    arc.ReadFloat(&waitUntil);
+   arc.ReadInteger(&yieldedInstructions);
    arc.ReadString(&waitingFor);
    arc.ReadObjectPointer((Class **)&waitingForThread);
    arc.ReadString(&waitingForConsole);
@@ -321,6 +353,7 @@ public:
    int                  linenumber;
    qboolean             doneProcessing;
    float                waitUntil;
+   int                  yieldedInstructions;
    str                  waitingFor;
    ScriptThread        *waitingForThread;
    str                  waitingForConsole;
@@ -340,6 +373,7 @@ inline EXPORT_FROM_DLL void ThreadMarker::Archive(Archiver &arc)
    arc.WriteInteger(linenumber);
    arc.WriteBoolean(doneProcessing);
    arc.WriteFloat(waitUntil);
+   arc.WriteInteger(yieldedInstructions);
    arc.WriteString(waitingFor);
    arc.WriteObjectPointer(waitingForThread);
    arc.WriteString(waitingForConsole);
@@ -357,6 +391,7 @@ inline EXPORT_FROM_DLL void ThreadMarker::Unarchive(Archiver &arc)
    arc.ReadInteger(&linenumber);
    arc.ReadBoolean(&doneProcessing);
    arc.ReadFloat(&waitUntil);
+   arc.ReadInteger(&yieldedInstructions);
    arc.ReadString(&waitingFor);
    arc.ReadObjectPointer((Class **)&waitingForThread);
    arc.ReadString(&waitingForConsole);
@@ -376,6 +411,25 @@ protected:
    int                        threadIndex   = 0;
    qboolean                   player_ready  = false;
 
+   // thread number map and wait registries
+   ScriptThread              *threadHash[SCRIPT_THREAD_HASHSIZE] = {};
+   scriptwait_t              *waitHash[NUM_WAIT_TYPES][SCRIPT_WAIT_HASHSIZE] = {};
+   qboolean                   waitsDirty    = false;
+
+   // script time used this frame, see BeginFrame
+   int                        scriptDepth       = 0;
+   unsigned                   scriptStart       = 0;
+   unsigned                   frameScriptTime   = 0;
+   int                        frameInstructions = 0;
+   int                        frameYields       = 0;
+
+   void                       AddThreadToMap(ScriptThread *thread);
+   void                       RemoveThreadFromMap(ScriptThread *thread);
+   void                       LinkWait(ScriptThread *thread, int type, unsigned hash);
+   void                       UnlinkWaits(ScriptThread *thread);
+   void                       RebuildWaits();
+   void                       FindWaiters(int type, unsigned hash, Container<ThreadPtr> &list);
+
 public:
    CLASS_PROTOTYPE(ScriptMaster);
 
@@ -404,7 +458,15 @@ public:
    qboolean                   Goto(GameScript * scr, const char *name);
    qboolean                   labelExists(GameScript * scr, const char *name);
    int                        GetUniqueThreadNumber();
+   void                       UpdateWaits(ScriptThread *thread);
    void                       FindLabels();
+   void                       BeginFrame();
+   void                       EnterScript();
+   void                       LeaveScript(int instructions, qboolean yielded);
+   qboolean                   SliceExpired(int instructions);
+   unsigned                   FrameScriptTime();
+   int                        FrameInstructions();
+   int                        FrameYields();
    virtual void               Archive(Archiver &arc)   override;
    virtual void               Unarchive(Archiver &arc) override;
 };
@@ -447,6 +509,13 @@ inline EXPORT_FROM_DLL void ScriptMaster::Unarchive(Archiver &arc)
 
    // make sure the list is cleared out
    Threads.FreeObjectList();
+   memset(threadHash, 0, sizeof(threadHash));
+
+   // thread pointers aren't fixed up until the archive is closed, so the
+   // wait registries are rebuilt the first time they're used
+   memset(waitHash, 0, sizeof(waitHash));
+   waitsDirty = true;
+
    // read in the the number of threads
    num = arc.ReadInteger();
    for(i = 1; i <= num; i++)
@@ -454,11 +523,14 @@ inline EXPORT_FROM_DLL void ScriptMaster::Unarchive(Archiver &arc)
       ptr = new ScriptThread();
       arc.ReadObject(ptr);
       Threads.AddObject(ptr);
+      AddThreadToMap(ptr);
    }
 }
 
 extern ScriptMaster Director;
 
+void G_ScriptProfileCommand();
+
 #endif /* scriptmaster.h */
 
 // EOF
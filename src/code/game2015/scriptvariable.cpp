@@ -20,6 +20,7 @@
 #include "scriptmaster.h"
 #include "sentient.h" //###
 #include "weapon.h"   //###
+#include "../elib/qstring.h"
 
 Event EV_Var_Append("append");
 Event EV_Var_AppendInt("appendint");
@@ -155,22 +156,62 @@ EXPORT_FROM_DLL qboolean ScriptVariable::isVariableCommand(const char *name)
 
 EXPORT_FROM_DLL void ScriptVariable::setName(const char *newname)
 {
-   name = newname;
+   // the name is used as the hash key, so it can't be changed while the variable is in a list
+   name = G_InternScriptString(newname);
+   namehash = qstring::HashCodeCaseStatic(name);
 }
 
 EXPORT_FROM_DLL const char *ScriptVariable::getName(void)
 {
-   return name.c_str();
+   return name;
+}
+
+EXPORT_FROM_DLL unsigned ScriptVariable::getNameHash(void)
+{
+   return namehash;
+}
+
+EXPORT_FROM_DLL void ScriptVariable::buildString(void)
+{
+   char text[128];
+
+   switch(type)
+   {
+   case VARTYPE_INT:
+      snprintf(text, sizeof(text), "%d", intvalue);
+      break;
+
+   case VARTYPE_FLOAT:
+      snprintf(text, sizeof(text), "%f", value);
+      break;
+
+   case VARTYPE_VECTOR:
+      snprintf(text, sizeof(text), "(%f %f %f)", vec.x, vec.y, vec.z);
+      break;
+
+   default:
+      return;
+   }
+
+   string = text;
+   stringvalid = true;
 }
 
 EXPORT_FROM_DLL const char *ScriptVariable::stringValue(void)
 {
+   if(!stringvalid)
+   {
+      buildString();
+   }
+
    return string.c_str();
 }
 
 EXPORT_FROM_DLL void ScriptVariable::setString(const char *value)
 {
    string = value;
+   type = VARTYPE_STRING;
+   stringvalid = true;
 }
 
 EXPORT_FROM_DLL void ScriptVariable::setStringValue(const char *newvalue)
@@ -186,11 +227,10 @@ EXPORT_FROM_DLL int ScriptVariable::intValue(void)
 
 EXPORT_FROM_DLL void ScriptVariable::setIntValue(int newvalue)
 {
-   char text[128];
-
    value = (float)newvalue;
-   snprintf(text, sizeof(text), "%d", newvalue);
-   setString(text);
+   intvalue = newvalue;
+   type = VARTYPE_INT;
+   stringvalid = false;
 }
 
 EXPORT_FROM_DLL float ScriptVariable::floatValue(void)
@@ -200,20 +240,17 @@ EXPORT_FROM_DLL float ScriptVariable::floatValue(void)
 
 EXPORT_FROM_DLL void ScriptVariable::setFloatValue(float newvalue)
 {
-   char text[128];
-
    value = newvalue;
-   snprintf(text, sizeof(text), "%f", newvalue);
-   setString(text);
+   type = VARTYPE_FLOAT;
+   stringvalid = false;
 }
 
 EXPORT_FROM_DLL void ScriptVariable::setVectorValue(Vector newvector)
 {
-   char text[128];
-
+   // the float value is left alone, same as when the text form was stored immediately
    vec = newvector;
-   snprintf(text, sizeof(text), "(%f %f %f)", newvector.x, newvector.y, newvector.z);
-   setString(text);
+   type = VARTYPE_VECTOR;
+   stringvalid = false;
 }
 
 EXPORT_FROM_DLL Vector ScriptVariable::vectorValue()
@@ -231,23 +268,125 @@ ResponseDef ScriptVariableList::Responses[] =
 ScriptVariableList::~ScriptVariableList()
 {
    ClearList();
+   delete[] hashTable;
 }
 
-EXPORT_FROM_DLL void ScriptVariableList::ClearList(void)
+//
+// Returns the hash slot holding the named variable, or the empty slot where
+// it would go.
+//
+int ScriptVariableList::FindSlot(const char *name, unsigned hash)
+{
+   ScriptVariable *var;
+   int             mask;
+   int             i;
+
+   mask = hashSize - 1;
+   for(i = hash & mask; (var = hashTable[i]) != nullptr; i = (i + 1) & mask)
+   {
+      if((var->getNameHash() == hash) && ((var->getName() == name) || !strcmp(var->getName(), name)))
+      {
+         break;
+      }
+   }
+
+   return i;
+}
+
+void ScriptVariableList::ResizeHash(int newsize)
 {
    int i;
    int num;
+
+   delete[] hashTable;
+   hashSize = newsize;
+   hashTable = new ScriptVariable *[hashSize];
+   memset(hashTable, 0, hashSize * sizeof(ScriptVariable *));
+
+   num = list.NumObjects();
+   for(i = 1; i <= num; i++)
+   {
+      HashInsert(list.ObjectAt(i));
+   }
+}
+
+void ScriptVariableList::HashInsert(ScriptVariable *var)
+{
+   hashTable[FindSlot(var->getName(), var->getNameHash())] = var;
+}
+
+void ScriptVariableList::HashRemove(ScriptVariable *var)
+{
+   int mask;
+   int i;
+   int j;
+   int home;
+
+   if(!hashTable)
+   {
+      return;
+   }
+
+   mask = hashSize - 1;
+   i = FindSlot(var->getName(), var->getNameHash());
+   if(hashTable[i] != var)
+   {
+      return;
+   }
+
+   // shift back any entries in the same run that would no longer be reachable
+   hashTable[i] = nullptr;
+   for(j = (i + 1) & mask; hashTable[j]; j = (j + 1) & mask)
+   {
+      home = hashTable[j]->getNameHash() & mask;
+      if((i <= j) ? ((home <= i) || (home > j)) : ((home <= i) && (home > j)))
+      {
+         hashTable[i] = hashTable[j];
+         hashTable[j] = nullptr;
+         i = j;
+      }
+   }
+}
+
+//
+// Creates a variable without checking if it exists
+//
+ScriptVariable *ScriptVariableList::NewVariable(const char *name)
+{
    ScriptVariable *var;
 
+   var = new ScriptVariable();
+   var->setName(name);
+   list.AddObject(var);
+
+   if((list.NumObjects() * 2) > hashSize)
+   {
+      ResizeHash(hashSize ? (hashSize * 2) : 16);
+   }
+   else
+   {
+      HashInsert(var);
+   }
+
+   return var;
+}
+
+EXPORT_FROM_DLL void ScriptVariableList::ClearList(void)
+{
+   int i;
+   int num;
+
    num = NumVariables();
    for(i = num; i > 0; i--)
    {
-      var = GetVariable(i);
-      RemoveVariable(var);
-      delete var;
+      delete GetVariable(i);
    }
 
    list.FreeObjectList();
+   if(hashTable)
+   {
+      memset(hashTable, 0, hashSize * sizeof(ScriptVariable *));
+   }
 }
 
 EXPORT_FROM_DLL void ScriptVariableList::AddVariable(ScriptVariable *var)
@@ -259,6 +398,14 @@ EXPORT_FROM_DLL void ScriptVariableList::AddVariable(ScriptVariable *var)
    }
 
    list.AddObject(var);
+   if((list.NumObjects() * 2) > hashSize)
+   {
+      ResizeHash(hashSize ? (hashSize * 2) : 16);
+   }
+   else
+   {
+      HashInsert(var);
+   }
 }
 
 EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *name, float value)
@@ -271,10 +418,8 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *n
       return GetVariable(name);
    }
 
-   var = new ScriptVariable();
-   var->setName(name);
+   var = NewVariable(name);
    var->setFloatValue(value);
-   list.AddObject(var);
 
    return var;
 }
@@ -289,10 +434,8 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *n
       return GetVariable(name);
    }
 
-   var = new ScriptVariable();
-   var->setName(name);
+   var = NewVariable(name);
    var->setIntValue(value);
-   list.AddObject(var);
 
    return var;
 }
@@ -307,10 +450,8 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *n
       return GetVariable(name);
    }
 
-   var = new ScriptVariable();
-   var->setName(name);
+   var = NewVariable(name);
    var->setStringValue(text);
-   list.AddObject(var);
 
    return var;
 }
@@ -327,9 +468,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *n
       return GetVariable(name);
    }
 
-   var = new ScriptVariable();
-   var->setName(name);
-   list.AddObject(var);
+   var = NewVariable(name);
 
    if(!ent)
    {
@@ -356,22 +495,21 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::CreateVariable(const char *n
       return GetVariable(name);
    }
 
-   var = new ScriptVariable();
-   var->setName(name);
+   var = NewVariable(name);
    var->setStringValue(va("(%f %f %f)", vec.x, vec.y, vec.z));
-   list.AddObject(var);
 
    return var;
 }
 
 EXPORT_FROM_DLL void ScriptVariableList::RemoveVariable(ScriptVariable *var)
 {
-   if(!list.ObjectInList(var))
+   if(GetVariable(var->getName()) != var)
    {
       warning("RemoveVariable", "Variable %s does not exist.\n", var->getName());
       return;
    }
 
+   HashRemove(var);
    list.RemoveObject(var);
 }
 
@@ -391,40 +529,33 @@ EXPORT_FROM_DLL void ScriptVariableList::RemoveVariable(const char *name)
 
 EXPORT_FROM_DLL qboolean ScriptVariableList::VariableExists(const char *name)
 {
-   int i;
-   int num;
-   ScriptVariable *var;
+   return GetVariable(name) != nullptr;
+}
 
-   num = list.NumObjects();
-   for(i = 1; i <= num; i++)
+EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::GetVariable(const char *name)
+{
+   if(!hashTable)
    {
-      var = list.ObjectAt(i);
-      if(!strcmp(var->getName(), name))
-      {
-         return true;
-      }
+      return nullptr;
    }
 
-   return false;
+   return hashTable[FindSlot(name, qstring::HashCodeCaseStatic(name))];
 }
 
-EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::GetVariable(const char *name)
+//
+// Same as GetVariable, but creates the variable if it doesn't exist.  Used by ScriptVariableSlot.
+//
+EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::ResolveVariable(const char *name)
 {
-   int i;
-   int num;
    ScriptVariable *var;
 
-   num = list.NumObjects();
-   for(i = 1; i <= num; i++)
+   var = GetVariable(name);
+   if(!var)
    {
-      var = list.ObjectAt(i);
-      if(!strcmp(var->getName(), name))
-      {
-         return var;
-      }
+      var = NewVariable(name);
    }
 
-   return NULL;
+   return var;
 }
 
 EXPORT_FROM_DLL int ScriptVariableList::NumVariables()
@@ -441,14 +572,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::SetVariable(const char *name
 {
    ScriptVariable *var;
 
-   var = GetVariable(name);
-   if(!var)
-   {
-      var = new ScriptVariable();
-      var->setName(name);
-      list.AddObject(var);
-   }
-
+   var = ResolveVariable(name);
    var->setFloatValue(value);
 
    return var;
@@ -458,14 +582,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::SetVariable(const char *name
 {
    ScriptVariable *var;
 
-   var = GetVariable(name);
-   if(!var)
-   {
-      var = new ScriptVariable();
-      var->setName(name);
-      list.AddObject(var);
-   }
-
+   var = ResolveVariable(name);
    var->setIntValue(value);
 
    return var;
@@ -475,14 +592,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::SetVariable(const char *name
 {
    ScriptVariable *var;
 
-   var = GetVariable(name);
-   if(!var)
-   {
-      var = new ScriptVariable();
-      var->setName(name);
-      list.AddObject(var);
-   }
-
+   var = ResolveVariable(name);
    var->setStringValue(text);
 
    return var;
@@ -492,13 +602,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::SetVariable(const char *name
 {
    ScriptVariable *var;
 
-   var = GetVariable(name);
-   if(!var)
-   {
-      var = new ScriptVariable();
-      var->setName(name);
-      list.AddObject(var);
-   }
+   var = ResolveVariable(name);
 
    if(!ent)
    {
@@ -517,14 +621,7 @@ EXPORT_FROM_DLL ScriptVariable *ScriptVariableList::SetVariable(const char *name
 {
    ScriptVariable *var;
 
-   var = GetVariable(name);
-   if(!var)
-   {
-      var = new ScriptVariable();
-      var->setName(name);
-      list.AddObject(var);
-   }
-
+   var = ResolveVariable(name);
    var->setStringValue(va("(%f %f %f)", vec.x, vec.y, vec.z));
 
    return var;
@@ -540,7 +637,7 @@ void ScriptVariable::Var_Append(Event *ev)
 {
    str newstring;
 
-   newstring = string + ev->GetString(1);
+   newstring = str(stringValue()) + ev->GetString(1);
    setStringValue(newstring.c_str());
 }
 
@@ -548,7 +645,7 @@ void ScriptVariable::Var_AppendInt(Event *ev)
 {
    str newstring;
 
-   newstring = string + va("%d", ev->GetInteger(1));
+   newstring = str(stringValue()) + va("%d", ev->GetInteger(1));
    setStringValue(newstring.c_str());
 }
 
@@ -556,7 +653,7 @@ void ScriptVariable::Var_AppendFloat(Event *ev)
 {
    str newstring;
 
-   newstring = string + va("%f", ev->GetFloat(1));
+   newstring = str(stringValue()) + va("%f", ev->GetFloat(1));
    setStringValue(newstring.c_str());
 }
 
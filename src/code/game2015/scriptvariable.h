@@ -66,15 +66,32 @@ extern Event EV_Var_GetTarget;
 extern Event EV_Var_GetWeapon;
 //###
 
+//
+// The type of the last value assigned to a variable.  Numbers and vectors are
+// only converted to text when stringValue is called.
+//
+typedef enum
+{
+   VARTYPE_STRING,
+   VARTYPE_INT,
+   VARTYPE_FLOAT,
+   VARTYPE_VECTOR
+} vartype_t;
+
 class ScriptVariable : public Listener
 {
 private:
-   str                  name;
+   const char          *name     = "";    // interned
+   unsigned             namehash = 0;
+   int                  type     = VARTYPE_STRING;
+   qboolean             stringvalid = true;
+   int                  intvalue = 0;
    float                value  = 0.0f;
    str                  string;
    Vector               vec;
 
    void                 setString(const char *newvalue);
+   void                 buildString();
 
 public:
    CLASS_PROTOTYPE(ScriptVariable);
@@ -83,6 +100,7 @@ public:
 
    void                 setName(const char *newname);
    const char          *getName();
+   unsigned             getNameHash();
 
    const char          *stringValue();
    void                 setStringValue(const char *newvalue);
@@ -152,24 +170,41 @@ public:
 
 inline void ScriptVariable::Archive(Archiver &arc)
 {
-   arc.WriteString(name);
+   str n = name;
+   str text = stringValue();
+
+   arc.WriteString(n);
    arc.WriteFloat(value);
-   arc.WriteString(string);
+   arc.WriteString(text);
    arc.WriteVector(vec);
 }
 
 inline void ScriptVariable::Unarchive(Archiver &arc)
 {
-   name = arc.ReadString();
+   setName(arc.ReadString().c_str());
    value = arc.ReadFloat();
    string = arc.ReadString();
    vec = arc.ReadVector();
+   type = VARTYPE_STRING;
+   stringvalid = true;
 }
 
+//
+// Variables are kept in creation order in list, and also in an open addressed
+// hash table (linear probing, kept at most half full) for lookups by name.
+//
 class ScriptVariableList : public Class
 {
 private:
    Container<ScriptVariable *> list;
+   ScriptVariable            **hashTable = nullptr;
+   int                         hashSize  = 0;
+
+   int             FindSlot(const char *name, unsigned hash);
+   void            HashInsert(ScriptVariable *var);
+   void            HashRemove(ScriptVariable *var);
+   void            ResizeHash(int newsize);
+   ScriptVariable *NewVariable(const char *name);
 
 public:
    CLASS_PROTOTYPE(ScriptVariableList);
@@ -187,6 +222,7 @@ public:
    void            RemoveVariable(const char *name);
    qboolean        VariableExists(const char *name);
    ScriptVariable *GetVariable(const char *name);
+   ScriptVariable *ResolveVariable(const char *name);
    int             NumVariables();
    ScriptVariable *GetVariable(int num);
    ScriptVariable *SetVariable(const char *name, float value);
@@ -231,6 +267,40 @@ inline void ScriptVariableList::Unarchive(Archiver &arc)
 
 typedef SafePtr<ScriptVariable> ScriptVariablePtr;
 
+//
+// Caches a variable that is looked up by name over and over, such as
+// parm.currentthread.  The variable is found (or created) the first time
+// Resolve is called and kept in a safe pointer, so it is only looked up again
+// when it is removed or a different list is passed in.
+//
+class ScriptVariableSlot
+{
+private:
+   const char         *name;
+   ScriptVariableList *list = nullptr;
+   ScriptVariablePtr   var;
+
+public:
+   ScriptVariableSlot(const char *varname);
+   ScriptVariable *Resolve(ScriptVariableList *vars);
+};
+
+inline ScriptVariableSlot::ScriptVariableSlot(const char *varname)
+   : name(varname)
+{
+}
+
+inline ScriptVariable *ScriptVariableSlot::Resolve(ScriptVariableList *vars)
+{
+   if(!var || (vars != list))
+   {
+      list = vars;
+      var = vars->ResolveVariable(name);
+   }
+
+   return var;
+}
+
 #endif /* scriptvariable.h */
 
 // EOF
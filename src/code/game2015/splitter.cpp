@@ -113,7 +113,7 @@ void Splitter::KilledEvent(Event *ev)
    // Double all the armor
    DoubleArmor();
 
-   SetVariable("other", ev->GetEntity(1));
+   SetVariable(otherVar, ev->GetEntity(1));
    if(!DoAction("killed") && actorthread)
       actorthread->ProcessEvent(EV_ScriptThread_End);
 
@@ -45,6 +45,7 @@ TestWeapon::TestWeapon() : Weapon()
    SetRank(0, 0);
 
    flags |= FL_PRETHINK;
+   Wake();
 }
 
 void TestWeapon::Prethink()
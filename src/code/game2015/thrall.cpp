@@ -634,6 +634,7 @@ EXPORT_FROM_DLL void DrunkMissile::Setup(Entity *owner, Vector pos, Vector dir)
    edict->owner = owner->edict;
 
    flags |= FL_PRETHINK;
+   Wake();
 
    setMoveType(MOVETYPE_FLYMISSILE);
    setSolidType(SOLID_BBOX);
@@ -855,6 +856,7 @@ EXPORT_FROM_DLL void ThrallPulseDebris::Setup(Entity *owner, Vector pos, float s
    nexttouch = 0;
    spawntime = level.time;
    flags |= FL_PRETHINK;
+   Wake();
    setModel("thrallfire.def");
    setMoveType(MOVETYPE_BOUNCE);
    setSolidType(SOLID_TRIGGER);
@@ -214,17 +214,25 @@ void Turret::Killed(Event *ev)
    PostEvent(EV_Remove, 0);
 }
 
-qboolean Turret::CanSee(Entity *ent)
+void Turret::SightTrace(Entity *ent, tracerequest_t *req)
 {
    Vector start;
    Vector end;
-   trace_t trace;
 
    start = worldorigin + gunoffset;
    end = (ent->absmin + ent->absmax) * 0.5;
 
+   G_SetTraceRequest(req, start, vec_zero, vec_zero, end, this, MASK_OPAQUE, "Turret::CanSee");
+}
+
+qboolean Turret::CanSee(Entity *ent)
+{
+   tracerequest_t req;
+   trace_t trace;
+
    // Check if he's visible
-   trace = G_Trace(start, vec_zero, vec_zero, end, this, MASK_OPAQUE, "Turret::CanSee");
+   SightTrace(ent, &req);
+   G_TraceBatch(&req, &trace, 1);
    if(trace.fraction == 1.0 || trace.ent == ent->edict)
    {
       return true;
@@ -272,42 +280,73 @@ void Turret::Pain(Event *ev)
       enemy = attacker->entnum;
 }
 
+#define TURRET_SIGHT_BATCH 16
+
 qboolean Turret::FindTarget()
 {
    Entity	*ent;
    edict_t	*ed;
    int		i;
+   int      j;
+   int      num;
    float		dist;
    float		bestdist;
    Entity	*bestent;
+   Entity         *targets[TURRET_SIGHT_BATCH];
+   float           dists[TURRET_SIGHT_BATCH];
+   tracerequest_t  requests[TURRET_SIGHT_BATCH];
+   trace_t         results[TURRET_SIGHT_BATCH];
 
    bestent = nullptr;
    bestdist = wakeupdistance + 1;
-   for(i = 0; i < game.maxclients; i++)
+   num = 0;
+
+   // gather up the clients in range and check whether we can see them a
+   // batch at a time.  The closest visible one wins, same as checking them
+   // one by one.
+   for(i = 0; i <= game.maxclients; i++)
    {
-      ed = &g_edicts[1 + i];
-      if(!ed->inuse || !ed->entity)
+      if(i < game.maxclients)
       {
-         continue;
-      }
+         ed = &g_edicts[1 + i];
+         if(!ed->inuse || !ed->entity)
+         {
+            continue;
+         }
 
-      ent = ed->entity;
-      if((ent->health < 0) || (ent->flags & FL_NOTARGET))
-      {
-         continue;
-      }
+         ent = ed->entity;
+         if((ent->health < 0) || (ent->flags & FL_NOTARGET))
+         {
+            continue;
+         }
 
-      dist = Distance(ent);
-      if(Range(dist) == TURRET_OUTOFRANGE)
-      {
-         continue;
+         dist = Distance(ent);
+         if((Range(dist) == TURRET_OUTOFRANGE) || (dist >= bestdist))
+         {
+            continue;
+         }
+
+         targets[num] = ent;
+         dists[num] = dist;
+         SightTrace(ent, &requests[num]);
+         num++;
+
+         if(num < TURRET_SIGHT_BATCH)
+         {
+            continue;
+         }
       }
 
-      if((dist < bestdist) && CanSee(ent))
+      G_TraceBatch(requests, results, num);
+      for(j = 0; j < num; j++)
       {
-         bestent = ent;
-         bestdist = dist;
+         if((dists[j] < bestdist) && (results[j].fraction == 1.0 || results[j].ent == targets[j]->edict))
+         {
+            bestent = targets[j];
+            bestdist = dists[j];
+         }
       }
+      num = 0;
    }
 
    if(bestent)
@@ -49,6 +49,7 @@ public:
    Turret();
 
    virtual qboolean        CanSee(Entity *ent);
+   void                    SightTrace(Entity *ent, tracerequest_t *req);
    virtual int             Range(float dist);
    virtual float           Distance(Entity *targ);
    virtual void            Pain(Event *ev);
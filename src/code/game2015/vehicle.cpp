@@ -541,6 +541,7 @@ foundpos:
       offset = other->worldorigin - worldorigin;
 
       flags |= FL_POSTTHINK;
+      Wake();
       SetDriverAngles(worldangles + seatangles);
    }
 }
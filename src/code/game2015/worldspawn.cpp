@@ -29,6 +29,7 @@
 //###
 #include "spritegun.h"   // added for spritegun
 #include "checkpoints.h"
+#include "../elib/qstring.h"
 //###
 
 extern void CreateMissionComputer();
@@ -280,18 +281,67 @@ World::World() : Entity()
    level.earthquake = 0;
 }
 
+//
+// Target lists are chained into a hash table keyed on the target name.  The table
+// is kept at least as large as the number of lists and is rebuilt when it fills.
+//
+void World::HashTargetList(TargetList *targetlist)
+{
+   TargetList **oldhash;
+   TargetList  *t;
+   TargetList  *next;
+   int          oldsize;
+   int          i;
+
+   if(targetList.NumObjects() > targetHashSize)
+   {
+      oldhash = targetHash;
+      oldsize = targetHashSize;
+
+      targetHashSize = oldsize ? oldsize * 2 : 256;
+      targetHash = new TargetList *[targetHashSize];
+      memset(targetHash, 0, targetHashSize * sizeof(TargetList *));
+
+      for(i = 0; i < oldsize; i++)
+      {
+         for(t = oldhash[i]; t; t = next)
+         {
+            next = t->hashNext;
+            t->hashNext = targetHash[t->namehash & (targetHashSize - 1)];
+            targetHash[t->namehash & (targetHashSize - 1)] = t;
+         }
+      }
+
+      delete[] oldhash;
+   }
+
+   i = targetlist->namehash & (targetHashSize - 1);
+   targetlist->hashNext = targetHash[i];
+   targetHash[i] = targetlist;
+}
+
 TargetList *World::GetTargetList(str &targetname)
 {
    TargetList *targetlist;
+   unsigned    hash;
 
-   for(int i = 1; i <= targetList.NumObjects(); i++)
+   hash = (unsigned)qstring::HashCodeCaseStatic(targetname.c_str());
+   if(targetHash)
    {
-      targetlist = targetList.ObjectAt(i);
-      if(targetname == targetlist->targetname)
-         return targetlist;
+      for(targetlist = targetHash[hash & (targetHashSize - 1)]; targetlist; targetlist = targetlist->hashNext)
+      {
+         if((targetlist->namehash == hash) && (targetname == targetlist->targetname))
+         {
+            return targetlist;
+         }
+      }
    }
+
    targetlist = new TargetList(targetname);
+   targetlist->namehash = hash;
    targetList.AddObject(targetlist);
+   HashTargetList(targetlist);
+
    return targetlist;
 }
 
@@ -355,6 +405,10 @@ void World::FreeTargetList()
    }
 
    targetList.FreeObjectList();
+
+   delete[] targetHash;
+   targetHash = nullptr;
+   targetHashSize = 0;
 }
 
 //
@@ -399,12 +453,27 @@ Entity *TargetList::GetNextEntity(Entity * ent)
 
    index = 0;
    if(ent)
-      index = list.IndexOfObject(ent);
+   {
+      // Loops over a target list pass back the entity we returned last time,
+      // so check the cursor before searching for it.
+      if((cursor >= 1) && (cursor <= list.NumObjects()) && (list.ObjectAt(cursor) == ent))
+      {
+         index = cursor;
+      }
+      else
+      {
+         index = list.IndexOfObject(ent);
+      }
+   }
    index++;
    if(index > list.NumObjects())
+   {
+      cursor = 0;
       return nullptr;
-   else
-      return list.ObjectAt(index);
+   }
+
+   cursor = index;
+   return list.ObjectAt(index);
 }
 
 // EOF
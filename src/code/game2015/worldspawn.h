@@ -32,6 +32,9 @@ public:
    CLASS_PROTOTYPE(TargetList);
    Container<Entity *>  list;
    str                  targetname;
+   unsigned             namehash = 0;
+   TargetList          *hashNext = nullptr;   // chain in World::targetHash
+   int                  cursor   = 0;         // index of the entity last returned by GetNextEntity
 
    TargetList() = default;
    TargetList(str &tname);
@@ -49,6 +52,10 @@ class EXPORT_FROM_DLL World : public Entity
 {
 private:
    Container<TargetList *> targetList;
+   TargetList            **targetHash     = nullptr;
+   int                     targetHashSize = 0;
+
+   void        HashTargetList(TargetList *targetlist);
 
 public:
    CLASS_PROTOTYPE(World);